@@ -1,7 +1,24 @@
 #include "Core_Arena.h"
+#include "Core_ArenaRegistry.h"
+#include "Core_ConcurrentArena.h"
+#include "Core_ConcurrentPool.h"
+#include "Core_ConcurrentQueue.h"
+#include "Core_DoubleEndedArena.h"
+#include "Core_FlatMap.h"
+#include "Core_FrameArena.h"
+#include "Core_HashMap.h"
+#include "Core_PersistentArena.h"
+#include "Core_Slab.h"
+#include "Core_SoA.h"
+#include "Core_Tlsf.h"
 #include "Core_String.h"
 #include "Core_Vector.h"
 #include "stdio.h"
+#include "stdlib.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 void RunTest_StringBuffer()
 {
@@ -121,6 +138,67 @@ void RunTest_QueueArena( Bogus::Core::Arena* pArena )
     }
 }
 
+void RunTest_QueueRing()
+{
+    printf( "\n\nTesting Ring Queue..." );
+    using namespace Bogus::Core;
+
+    // NOTE(asr): Keep the queue wrapped while it grows so every resize has to unwrap
+    RegionQueue<uint32> queue;
+    uint32 uiNextPush = 0;
+    uint32 uiNextPop = 0;
+    uint32 uiMismatches = 0;
+    for( uint32 uiRound = 0; uiRound < 12; ++uiRound )
+    {
+        for( uint32 i = 0; i < 3 + uiRound * 5; ++i )
+        {
+            queue.push( uiNextPush++ );
+        }
+        for( uint32 i = 0; i < 2 + uiRound * 3; ++i )
+        {
+            uiMismatches += queue.front() != uiNextPop++;
+            queue.pop();
+        }
+    }
+    for( uint32 const uiValue : queue )
+    {
+        uiMismatches += uiValue != uiNextPop++;
+    }
+    uiNextPop -= queue.count();
+
+    uint32 pBulk[100];
+    for( uint32 i = 0; i < 100; ++i )
+    {
+        pBulk[i] = uiNextPush++;
+    }
+    queue.push_n( pBulk, 100 );
+    uiMismatches += queue.back() != uiNextPush - 1;
+
+    uint32 pOut[64];
+    while( uint32 uiPopped = queue.pop_n( pOut, 64 ) )
+    {
+        for( uint32 i = 0; i < uiPopped; ++i )
+        {
+            uiMismatches += pOut[i] != uiNextPop++;
+        }
+    }
+    uiMismatches += uiNextPop != uiNextPush;
+
+    // Removing from either half keeps the order of the rest
+    for( uint32 i = 0; i < 10; ++i )
+    {
+        queue.push( i );
+    }
+    queue.remove( 2 );
+    queue.remove_elem( 8 );
+    uint32 const pExpected[] = { 0, 1, 3, 4, 5, 6, 7, 9 };
+    for( uint32 i = 0; i < queue.count(); ++i )
+    {
+        uiMismatches += queue[i] != pExpected[i];
+    }
+    printf( "\nCount: %u, slots: %u, mismatches: %u", queue.count(), queue.slots(), uiMismatches );
+}
+
 void RunTest_VectorHeap()
 {
     printf( "\n\nTesting Heap Vector..." );
@@ -278,25 +356,1511 @@ void RunTest_Arena()
     ArenaRelease( pArena );
 }
 
-void RunTest_VectorMap()
+void RunTest_ArenaLargePages()
 {
     using namespace Bogus::Core;
-    using Uint32MapPair = Bogus::Core::VectorMapPair<uint32, uint32>;
-    using Uint32MapPairVector = Bogus::Core::Vector<Bogus::Core::VectorPolicyArena<Uint32MapPair>>;
-    using Uint32Map = Bogus::Core::VectorMap<Uint32MapPairVector>;
+    Arena* pArena =
+        NEW_ARENA(.name = "LargePages",
+                  .uiFlags = Memory::eMemFlag_LargePages | Memory::eMemFlag_Prefault );
+    printf( "\n\nArena Created with name: %.*s", pArena->initParams.name.m_uiLen,
+            pArena->initParams.name.m_pData );
+    printf( "\nCommit step: %llu", pArena->initParams.uiCommitSize );
 
-    Uint32Map myMap;
-    myMap.add( 0, 69 );
-    myMap.add( 1, 420 );
-    myMap.add( 2, 911 );
-    myMap.add( Bogus::Core::String::CalcHash( "Key1" ), 1234 );
+    constexpr uint32 NUM_ELEMS = MEGABYTES( 4 ) / sizeof( uint32 );
+    uint32* pData = ArenaPushArray<uint32>( pArena, NUM_ELEMS );
+    for( uint32 i = 0; i < NUM_ELEMS; ++i )
+    {
+        pData[i] = i;
+    }
+    printf( "\nCommitted: %llu", pArena->uiCommittedSize );
 
-    uint32 uiCount = 4;
-    printf( "\n\nUint32Map: %d", uiCount );
-    for( Uint32MapPair const& Pair : myMap )
+    // Shrinking keeps whole large pages so they are not split
+    ArenaPopTo( pArena, ArenaGetPos( pArena ) - MEGABYTES( 3 ) );
+    ArenaDecommitUnused( pArena );
+    BGASSERT( pArena->uiCommittedSize % Memory::GetLargePageSize() == 0,
+              "Decommit split a large page." );
+    printf( "\nCommitted after shrinking: %llu", pArena->uiCommittedSize );
+    ArenaRelease( pArena );
+
+    // NOTE(asr): Without a hugetlbfs pool this has to fall back instead of faulting on touch
+    pArena = NEW_ARENA(.name = "HugeTLB", .uiFlags = Memory::eMemFlag_HugeTLB );
+    pData = ArenaPushArray<uint32>( pArena, NUM_ELEMS );
+    for( uint32 i = 0; i < NUM_ELEMS; ++i )
     {
-        printf( "\n[%u]: %u", Pair.m_Key, Pair.m_Element );
+        pData[i] = i;
+    }
+    printf( "\nHugeTLB committed: %llu, last: %u", pArena->uiCommittedSize, pData[NUM_ELEMS - 1] );
+    ArenaRelease( pArena );
+
+    // NOTE(asr): HugeTLB ranges only take whole large pages from the pool, not a full gigabyte
+    uint64 const uiHugeSize = Memory::GetReservedSize( MEGABYTES( 3 ), Memory::eMemFlag_HugeTLB );
+    BGASSERT( uiHugeSize == 2 * Memory::GetLargePageSize(), "HugeTLB reserve was over sized." );
+    printf( "\nHugeTLB reserve for 3MB: %llu", uiHugeSize );
+}
+
+void RunTest_ScratchArena()
+{
+    printf( "\n\nTesting Scratch Arenas..." );
+    using namespace Bogus::Core;
+
+    ArenaTemp outer = GetScratch();
+    uint32* pOuter = ArenaPushArray<uint32>( outer.pArena, 16 );
+    pOuter[0] = 69;
+    {
+        ArenaTemp inner = GetScratch( outer.pArena );
+        BGASSERT( inner.pArena != outer.pArena, "Scratch conflict was not avoided." );
+        ArenaPushArray<uint32>( inner.pArena, 1024 );
+    }
+
+    uint64 const uiPos = ArenaGetPos( outer.pArena );
+    {
+        ArenaTemp nested = GetScratch();
+        ArenaPushArray<uint32>( nested.pArena, 1024 );
+    }
+    BGASSERT( ArenaGetPos( outer.pArena ) == uiPos, "Scratch position was not restored." );
+    printf( "\nOuter scratch value: %u", pOuter[0] );
+}
+
+void RunTest_ArenaDecommit()
+{
+    printf( "\n\nTesting Arena Decommit..." );
+    using namespace Bogus::Core;
+
+    Arena* pArena = NEW_ARENA(.name = "Decommit", .uiDecommitThreshold = MEGABYTES( 1 ) );
+    uint64 const uiStart = ArenaGetPos( pArena );
+
+    // NOTE(asr): A single spike followed by small frames should eventually give the spike back
+    ArenaPush( pArena, MEGABYTES( 16 ), 8 );
+    ArenaPopTo( pArena, uiStart );
+    uint64 const uiCommittedAfterSpike = pArena->uiCommittedSize;
+    for( uint32 i = 0; i < 64; ++i )
+    {
+        ArenaPush( pArena, KILOBYTES( 64 ), 8 );
+        ArenaPopTo( pArena, uiStart );
+    }
+    printf( "\nCommitted after spike: %llu, after decay: %llu", uiCommittedAfterSpike,
+            pArena->uiCommittedSize );
+
+    // NOTE(asr): Oscillating between two sizes should not keep decommitting
+    uint32 const uiDecommitsBefore = pArena->uiDecommitCount;
+    for( uint32 i = 0; i < 64; ++i )
+    {
+        ArenaPush( pArena, MEGABYTES( 4 ), 8 );
+        ArenaPopTo( pArena, uiStart );
+    }
+    printf( "\nCommits: %u, Decommits: %u (oscillating: %u)", pArena->uiCommitCount,
+            pArena->uiDecommitCount, pArena->uiDecommitCount - uiDecommitsBefore );
+    ArenaRelease( pArena );
+}
+
+void RunTest_ArenaChained()
+{
+    printf( "\n\nTesting Chained Arena..." );
+    using namespace Bogus::Core;
+
+    Arena* pArena = ArenaAlloc( { .uiReserveSize = MEGABYTES( 1 ),
+                                  .uiCommitSize = ARENA_DEFAULT_COMMIT_SIZE,
+                                  .name = "Chained",
+                                  .uiArenaFlags = eArenaFlag_Chained } );
+    uint64 const uiStart = ArenaGetPos( pArena );
+    uint32* pFirst = ArenaPushArray<uint32>( pArena, KILOBYTES( 128 ) );
+    pFirst[0] = 69;
+
+    uint64 const uiMark = ArenaGetPos( pArena );
+    uint32* pSecond = ArenaPushArray<uint32>( pArena, KILOBYTES( 512 ) );
+    pSecond[KILOBYTES( 512 ) - 1] = 420;
+    BGASSERT( pArena->pCurrent != pArena, "Arena did not chain a new block." );
+    printf( "\nPos after chaining: %llu", ArenaGetPos( pArena ) );
+
+    ArenaPopTo( pArena, uiMark );
+    BGASSERT( pArena->pCurrent == pArena, "Trailing block was not freed on pop." );
+    BGASSERT( ArenaGetPos( pArena ) == uiMark, "Pop did not restore the global position." );
+    printf( "\nPos after pop: %llu, first value: %u", ArenaGetPos( pArena ), pFirst[0] );
+
+    ArenaPushArray<uint32>( pArena, KILOBYTES( 512 ) );
+    BGASSERT( pArena->pCurrent->uiReservedSize % Memory::RESERVE_GRANULARITY == 0,
+              "Chained block does not fill its reservation." );
+
+    // NOTE(asr): Pushes far past the 1MB first block should still fit the one chained block
+    for( uint32 i = 0; i < 64; ++i )
+    {
+        ArenaPush( pArena, MEGABYTES( 8 ), 8 );
+    }
+    uint32 uiBlockCount = 0;
+    for( Arena* pBlock = pArena->pCurrent; pBlock; pBlock = pBlock->pPrev )
+    {
+        ++uiBlockCount;
+    }
+    BGASSERT( uiBlockCount == 2, "Chained arena took more reservations than needed." );
+    printf( "\nBlocks after 512MB: %u", uiBlockCount );
+
+    ArenaPopTo( pArena, uiStart );
+    ArenaRelease( pArena );
+}
+
+void RunTest_ConcurrentArena()
+{
+    printf( "\n\nTesting Concurrent Arena..." );
+    using namespace Bogus::Core;
+
+    constexpr uint32 NUM_THREADS = 4;
+    constexpr uint32 NUM_PUSHES = 10000;
+    ConcurrentArena* pArena = ConcurrentArenaAlloc( { .name = "ConcurrentArena" } );
+
+    std::thread threads[NUM_THREADS];
+    for( uint32 t = 0; t < NUM_THREADS; ++t )
+    {
+        threads[t] = std::thread(
+            [pArena, t]()
+            {
+                for( uint32 i = 0; i < NUM_PUSHES; ++i )
+                {
+                    uint32* pData = ConcurrentArenaPushArrayNoZero<uint32>( pArena, 3 );
+                    pData[0] = t;
+                    pData[1] = i;
+                    pData[2] = t ^ i;
+                }
+            } );
+    }
+    for( std::thread& thread : threads )
+    {
+        thread.join();
+    }
+
+    uint32 uiCorrupt = 0;
+    uint8* pBegin = ConcurrentArenaGetBegin( pArena );
+    uint64 const uiUsed = ConcurrentArenaGetPos( pArena ) - pArena->uiBasePos;
+    for( uint64 uiOffset = 0; uiOffset < uiUsed; uiOffset += CONCURRENT_ARENA_MIN_ALIGNMENT )
+    {
+        uint32* pData = (uint32*)( pBegin + uiOffset );
+        uiCorrupt += ( pData[0] ^ pData[1] ) != pData[2];
+    }
+    BGASSERT( uiCorrupt == 0, "Concurrent pushes overlapped." );
+    printf( "\nUsed: %llu, Commits: %u, Corrupt: %u", uiUsed, pArena->uiCommitCount.load(),
+            uiCorrupt );
+
+    // NOTE(asr): Mixed alignments and odd sizes, every block is filled with its own tag and must
+    // still hold it once all threads are done
+    struct Block
+    {
+        uint8* pData;
+        uint64 uiAlignment;
+        uint32 uiSize;
+        uint8 uiTag;
+    };
+    constexpr uint32 NUM_MIXED_PUSHES = 2000;
+    static Block blocks[NUM_THREADS][NUM_MIXED_PUSHES];
+    ConcurrentArenaClear( pArena );
+    for( uint32 t = 0; t < NUM_THREADS; ++t )
+    {
+        threads[t] = std::thread(
+            [pArena, t]()
+            {
+                uint64 const pAlignments[] = { 1, 8, 16, 32, 64, 256 };
+                for( uint32 i = 0; i < NUM_MIXED_PUSHES; ++i )
+                {
+                    uint64 const uiAlignment = pAlignments[( i * 7 + t ) % 6];
+                    uint32 const uiSize = 1 + ( i * 13 + t * 5 ) % 97;
+                    Block& block = blocks[t][i];
+                    block.pData = ConcurrentArenaPush( pArena, uiSize, uiAlignment );
+                    block.uiAlignment = uiAlignment;
+                    block.uiSize = uiSize;
+                    block.uiTag = (uint8)( t * NUM_MIXED_PUSHES + i );
+                    memset( block.pData, block.uiTag, uiSize );
+                }
+            } );
+    }
+    for( std::thread& thread : threads )
+    {
+        thread.join();
+    }
+    uint32 uiMixedCorrupt = 0;
+    for( uint32 t = 0; t < NUM_THREADS; ++t )
+    {
+        for( uint32 i = 0; i < NUM_MIXED_PUSHES; ++i )
+        {
+            Block const& block = blocks[t][i];
+            uiMixedCorrupt += ( (uint64)block.pData & ( block.uiAlignment - 1 ) ) != 0;
+            for( uint32 j = 0; j < block.uiSize; ++j )
+            {
+                uiMixedCorrupt += block.pData[j] != block.uiTag;
+            }
+        }
+    }
+
+    // The sequence that used to overlap, a 32 aligned push left the position 8 past a boundary
+    ConcurrentArenaClear( pArena );
+    uint8* pFirst = ConcurrentArenaPush( pArena, 8, 32 );
+    uint8* pSecond = ConcurrentArenaPush( pArena, 16, 8 );
+    uint8* pThird = ConcurrentArenaPush( pArena, 16, 1 );
+    uiMixedCorrupt += pSecond < pFirst + 8 || pThird < pSecond + 16;
+    uiMixedCorrupt += ( (uint64)pFirst & 31 ) != 0 || ( (uint64)pSecond & 7 ) != 0;
+    BGASSERT( uiMixedCorrupt == 0, "Mixed alignment pushes overlapped." );
+    printf( "\nMixed alignment corrupt: %u", uiMixedCorrupt );
+    ConcurrentArenaRelease( pArena );
+}
+
+void RunTest_ArenaRegistry()
+{
+    printf( "\n\nTesting Arena Registry..." );
+    using namespace Bogus::Core;
+
+    HeapVector<uint32> myVec;
+    for( uint32 i = 0; i < 1000; ++i )
+    {
+        myVec.push( i );
+    }
+
+    char szDump[KILOBYTES( 4 )];
+    uint64 const uiLen = ArenaRegistryDump( szDump, sizeof( szDump ), ArenaDumpFormat::CSV );
+    printf( "\n%s", szDump );
+    BGASSERT( uiLen < sizeof( szDump ), "Arena registry dump truncated." );
+
+    ArenaRegistryDump( szDump, sizeof( szDump ), ArenaDumpFormat::JSON );
+    printf( "%s", szDump );
+
+    // NOTE(asr): The owner can walk its own chain, the totals kept on the handle must match it
+    Arena* pChained = ArenaAlloc( { .uiReserveSize = MEGABYTES( 1 ),
+                                    .name = "RegistryChained",
+                                    .uiArenaFlags = eArenaFlag_Chained } );
+    uint64 const uiStart = ArenaGetPos( pChained );
+    ArenaPush( pChained, KILOBYTES( 768 ), 8 );
+    ArenaPush( pChained, MEGABYTES( 2 ), 8 );
+    ArenaStats const stats = ArenaGetStats( pChained );
+    ArenaStats walked;
+    for( Arena* pBlock = pChained->pCurrent; pBlock; pBlock = pBlock->pPrev )
+    {
+        walked.uiCommittedSize += pBlock->uiCommittedSize;
+        walked.uiReservedSize += pBlock->uiReservedSize;
+        walked.uiCommitCount += pBlock->uiCommitCount;
+        ++walked.uiBlockCount;
+    }
+    uint32 uiMismatches = stats.uiCommittedSize != walked.uiCommittedSize;
+    uiMismatches += stats.uiReservedSize != walked.uiReservedSize;
+    uiMismatches += stats.uiCommitCount != walked.uiCommitCount;
+    uiMismatches += stats.uiBlockCount != walked.uiBlockCount;
+    uiMismatches += stats.uiPos != ArenaGetPos( pChained );
+    ArenaPopTo( pChained, uiStart );
+    ArenaStats const popped = ArenaGetStats( pChained );
+    uiMismatches += popped.uiBlockCount != 1 || popped.uiReservedSize != pChained->uiReservedSize;
+    ArenaRelease( pChained );
+    BGASSERT( uiMismatches == 0, "Chained arena stats do not match its blocks." );
+    printf( "\nChained stats mismatches: %u", uiMismatches );
+}
+
+template <typename tAlloc, typename tFree>
+double RunBench_SmallAllocs( tAlloc allocFunc, tFree freeFunc )
+{
+    constexpr uint32 NUM_LIVE = 4096;
+    constexpr uint32 NUM_OPS = 1 << 21;
+    static void* s_pLive[NUM_LIVE];
+    static uint32 s_uiSizes[NUM_LIVE];
+
+    uint32 uiSeed = 0x1234567;
+    auto const start = std::chrono::high_resolution_clock::now();
+    for( uint32 i = 0; i < NUM_OPS; ++i )
+    {
+        uiSeed = uiSeed * 1664525u + 1013904223u;
+        uint32 const uiSlot = ( uiSeed >> 8 ) % NUM_LIVE;
+        if( s_pLive[uiSlot] )
+        {
+            freeFunc( s_pLive[uiSlot], s_uiSizes[uiSlot] );
+        }
+        s_uiSizes[uiSlot] = 16 + ( ( uiSeed >> 20 ) & 0x1ff );
+        s_pLive[uiSlot] = allocFunc( s_uiSizes[uiSlot] );
+        *(uint32*)s_pLive[uiSlot] = i;
+    }
+    for( uint32 i = 0; i < NUM_LIVE; ++i )
+    {
+        freeFunc( s_pLive[i], s_uiSizes[i] );
+        s_pLive[i] = nullptr;
+    }
+    auto const end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>( end - start ).count();
+}
+
+void RunTest_Slab()
+{
+    printf( "\n\nTesting Slab Allocator..." );
+    using namespace Bogus::Core;
+
+    struct TestElem
+    {
+        uint32 uiID = 0;
+        String::Buffer<128> name;
+    };
+    TestElem* pElem = SlabNew<TestElem>();
+    pElem->uiID = 69;
+    SlabDelete( pElem );
+
+    double const fSlabMs =
+        RunBench_SmallAllocs( []( uint64 uiSize ) { return SlabAlloc( uiSize ); },
+                              []( void* pMem, uint64 uiSize ) { SlabFree( pMem, uiSize ); } );
+    double const fMallocMs = RunBench_SmallAllocs( []( uint64 uiSize ) { return malloc( uiSize ); },
+                                                   []( void* pMem, uint64 ) { free( pMem ); } );
+    printf( "\nSlab: %.2fms, malloc: %.2fms", fSlabMs, fMallocMs );
+
+    uint64 uiUsage[SLAB_CLASS_COUNT];
+    SlabGetClassUsage( uiUsage );
+    for( uint32 i = 0; i < SLAB_CLASS_COUNT; ++i )
+    {
+        printf( "\n[%u]: %llu bytes", i, uiUsage[i] );
+    }
+}
+
+void RunTest_Tlsf()
+{
+    printf( "\n\nTesting TLSF Heap..." );
+    using namespace Bogus::Core;
+
+    TlsfHeap* pHeap = TlsfCreate( { .name = "TlsfHeap" } );
+    constexpr uint32 NUM_ALLOCS = 2048;
+    static void* s_pAllocs[NUM_ALLOCS];
+
+    uint32 uiSeed = 0xbeef;
+    for( uint32 i = 0; i < NUM_ALLOCS; ++i )
+    {
+        uiSeed = uiSeed * 1664525u + 1013904223u;
+        uint64 const uiSize = 1 + ( ( uiSeed >> 8 ) % KILOBYTES( 16 ) );
+        s_pAllocs[i] = TlsfAlloc( pHeap, uiSize );
+        memset( s_pAllocs[i], 0xab, uiSize );
+    }
+
+    // NOTE(asr): Free every other allocation to fragment the heap
+    for( uint32 i = 0; i < NUM_ALLOCS; i += 2 )
+    {
+        TlsfFree( pHeap, s_pAllocs[i] );
+    }
+    TlsfStats stats = TlsfGetStats( pHeap );
+    printf( "\nUsed: %llu, Free: %llu, Largest: %llu, Fragmentation: %.2f", stats.uiUsedSize,
+            stats.uiFreeSize, stats.uiLargestFreeBlock, stats.fFragmentation );
+
+    for( uint32 i = 1; i < NUM_ALLOCS; i += 2 )
+    {
+        TlsfFree( pHeap, s_pAllocs[i] );
+    }
+    stats = TlsfGetStats( pHeap );
+    BGASSERT( stats.uiUsedSize == 0, "TLSF heap leaked blocks." );
+    printf( "\nUsed: %llu, Free: %llu, Largest: %llu, Fragmentation: %.2f, Commits: %u",
+            stats.uiUsedSize, stats.uiFreeSize, stats.uiLargestFreeBlock, stats.fFragmentation,
+            pHeap->uiCommitCount );
+    TlsfDestroy( pHeap );
+}
+
+void RunTest_ArenaCache()
+{
+    printf( "\n\nTesting Arena Cache..." );
+    using namespace Bogus::Core;
+
+    ArenaCacheStats const before = ArenaCacheGetStats();
+    for( uint32 i = 0; i < 100; ++i )
+    {
+        HeapVector<uint32> myVec;
+        for( uint32 j = 0; j < 1000; ++j )
+        {
+            myVec.push( j );
+        }
+    }
+    ArenaCacheStats const after = ArenaCacheGetStats();
+    printf( "\nHits: %llu, Misses: %llu, Cached: %llu (%llu bytes committed)",
+            after.uiHits - before.uiHits, after.uiMisses - before.uiMisses, after.uiCachedCount,
+            after.uiCachedCommittedSize );
+    BGASSERT( after.uiMisses - before.uiMisses <= 1, "Short lived vectors missed the cache." );
+
+    // NOTE(asr): Both land in the 128MB class, neither may see more than it asked for
+    uint64 const uiSmallSize = MEGABYTES( 64 ) + ARENA_HEADER_SIZE;
+    uint64 const uiLargeSize = MEGABYTES( 100 );
+    Arena* pArena = ArenaAlloc( { .uiReserveSize = uiSmallSize, .name = "CacheSmall" } );
+    uint64 const uiSmallReserved = pArena->uiReservedSize;
+    ArenaRelease( pArena );
+    uint64 const uiHitsBefore = ArenaCacheGetStats().uiHits;
+    pArena = ArenaAlloc( { .uiReserveSize = uiLargeSize, .name = "CacheLarge" } );
+    uint64 const uiLargeReserved = pArena->uiReservedSize;
+    bool const bReused = ArenaCacheGetStats().uiHits > uiHitsBefore;
+    uint8* pEnd = ArenaPush( pArena, uiLargeSize - KILOBYTES( 4 ), 8 );
+    pEnd[uiLargeSize - KILOBYTES( 4 ) - 1] = 1;
+    ArenaRelease( pArena );
+    BGASSERT( uiSmallReserved == ALIGNUP_POW2( uiSmallSize, Memory::GetPageSize() ) &&
+                  uiLargeReserved == uiLargeSize,
+              "Arena cache changed the reserve size." );
+    printf( "\nReserved: %llu and %llu, reused: %d", uiSmallReserved, uiLargeReserved, bReused );
+}
+
+void RunTest_ArenaKnownZero()
+{
+    printf( "\n\nTesting Arena Known Zero..." );
+    using namespace Bogus::Core;
+
+    Arena* pArena = NEW_ARENA(.name = "KnownZero", .uiArenaFlags = eArenaFlag_NoRecycle );
+    uint64 const uiStart = ArenaGetPos( pArena );
+
+    uint64 uiDirtySize = 0;
+    uint8* pData = ArenaPush( pArena, MEGABYTES( 1 ), 8, &uiDirtySize );
+    BGASSERT( uiDirtySize == 0, "Fresh pages should be known zero." );
+    memset( pData, 0xab, KILOBYTES( 512 ) );
+
+    ArenaPopTo( pArena, uiStart );
+    uint32* pZeroed = ArenaPushArray<uint32>( pArena, MEGABYTES( 2 ) / sizeof( uint32 ) );
+    uint32 uiNonZero = 0;
+    for( uint32 i = 0; i < MEGABYTES( 2 ) / sizeof( uint32 ); ++i )
+    {
+        uiNonZero += pZeroed[i] != 0;
+    }
+    BGASSERT( uiNonZero == 0, "Reused memory was not cleared." );
+    printf( "\nZero pos: %llu, non zero: %u", pArena->uiZeroPos, uiNonZero );
+    ArenaRelease( pArena );
+}
+
+void RunTest_ArenaCommitGrowth()
+{
+    printf( "\n\nTesting Arena Commit Growth..." );
+    using namespace Bogus::Core;
+
+    auto PushAll = []( uint64 uiMaxCommitStep )
+    {
+        Arena* pArena = ArenaAlloc( { .uiReserveSize = MEGABYTES( 64 ),
+                                      .uiCommitSize = 16 * sizeof( uint32 ),
+                                      .name = "CommitGrowth",
+                                      .uiMaxCommitStep = uiMaxCommitStep } );
+        for( uint32 i = 0; i < MEGABYTES( 16 ) / sizeof( uint32 ); ++i )
+        {
+            *ArenaPushArrayNoZero<uint32>( pArena, 1 ) = i;
+        }
+        uint32 const uiCommitCount = pArena->uiCommitCount;
+        ArenaRelease( pArena );
+        return uiCommitCount;
+    };
+
+    uint32 const uiFixedCommits = PushAll( 16 * sizeof( uint32 ) );
+    uint32 const uiGeometricCommits = PushAll( ARENA_DEFAULT_MAX_COMMIT_STEP );
+    printf( "\nFixed step commits: %u, geometric commits: %u", uiFixedCommits,
+            uiGeometricCommits );
+}
+
+void RunTest_ArenaNuma()
+{
+    printf( "\n\nTesting Arena NUMA Placement..." );
+    using namespace Bogus::Core;
+
+    uint32 const uiNodeCount = Memory::GetNumaNodeCount();
+    printf( "\nNodes: %u, current node: %u", uiNodeCount, Memory::GetCurrentNumaNode() );
+
+    Arena* pInterleaved =
+        NEW_ARENA(.name = "Interleaved", .iNumaNode = Memory::NUMA_NODE_INTERLEAVE );
+    uint32* pData = ArenaPushArray<uint32>( pInterleaved, MEGABYTES( 4 ) / sizeof( uint32 ) );
+    pData[MEGABYTES( 4 ) / sizeof( uint32 ) - 1] = 1;
+    ArenaRelease( pInterleaved );
+
+    std::thread workers[4];
+    uint32 uiNodes[4] = {};
+    for( uint32 i = 0; i < 4; ++i )
+    {
+        workers[i] = std::thread(
+            [&uiNodes, i]()
+            {
+                Arena* pLocal = GetLocalNodeArena();
+                BGASSERT( pLocal == GetLocalNodeArena(), "Local node arena changed." );
+                *ArenaPushArrayNoZero<uint32>( pLocal, 1 ) = i;
+                uiNodes[i] = (uint32)pLocal->initParams.iNumaNode;
+                ReleaseLocalNodeArena();
+            } );
+    }
+    for( std::thread& worker : workers )
+    {
+        worker.join();
+    }
+    for( uint32 i = 0; i < 4; ++i )
+    {
+        BGASSERT( uiNodes[i] < uiNodeCount, "Local node arena on an unknown node." );
+        printf( "\nWorker %u arena on node %u", i, uiNodes[i] );
+    }
+}
+
+void RunTest_PersistentArena()
+{
+    printf( "\n\nTesting Persistent Arena..." );
+    using namespace Bogus::Core;
+
+    struct LookupTable
+    {
+        LookupTable( uint32* pData, uint32 uiCapacity ) : squares( { pData, uiCapacity } ) {}
+        PersistentVector<uint32> squares;
+    };
+
+    char const* szPath = "PersistentArenaTest.bin";
+    remove( szPath );
+    PersistentArenaParams const params = { .szPath = szPath, .uiCapacity = MEGABYTES( 1 ) };
+
+    bool bLoaded = true;
+    PersistentArena* pArena = PersistentArenaOpen( params, &bLoaded );
+    BGASSERT( !bLoaded, "A new file should not validate." );
+    LookupTable* pTable = PersistentArenaPushArrayNoZero<LookupTable>( pArena, 1 );
+    new( pTable ) LookupTable( PersistentArenaPushArray<uint32>( pArena, 1024 ), 1024 );
+    for( uint32 i = 0; i < 1024; ++i )
+    {
+        pTable->squares.push( i * i );
+    }
+    PersistentArenaSetRoot( pArena, pTable );
+    PersistentArenaSave( pArena );
+    PersistentArenaClose( pArena );
+
+    pArena = PersistentArenaOpen( params, &bLoaded );
+    BGASSERT( bLoaded, "Saved file failed validation." );
+    pTable = PersistentArenaGetRoot<LookupTable>( pArena );
+    uint32 uiMismatches = 0;
+    for( uint32 i = 0; i < pTable->squares.size(); ++i )
+    {
+        uiMismatches += pTable->squares[i] != i * i;
+    }
+    printf( "\nLoaded %u entries, %u mismatches", pTable->squares.size(), uiMismatches );
+
+    // Modifying without saving must invalidate the file
+    pTable->squares[3] = 0;
+    PersistentArenaClose( pArena );
+    pArena = PersistentArenaOpen( params, &bLoaded );
+    BGASSERT( !bLoaded, "Unsaved modification passed validation." );
+    PersistentArenaClose( pArena );
+    remove( szPath );
+}
+
+void RunTest_FrameArenaRing()
+{
+    printf( "\n\nTesting Frame Arena Ring..." );
+    using namespace Bogus::Core;
+
+    static constexpr uint32 FRAME_COUNT = 3;
+    FrameArenaRing ring;
+    FrameArenaRingInit( &ring, FRAME_COUNT, { .name = "FrameArena" } );
+
+    // NOTE(asr): Pretend the GPU runs FRAME_COUNT - 1 frames behind
+    uint64 uiFence = 0;
+    uint32* pFramePtrs[FRAME_COUNT] = {};
+    for( uint32 uiFrame = 0; uiFrame < 10; ++uiFrame )
+    {
+        uint32 const uiIndex = uiFrame % FRAME_COUNT;
+        uint64 const uiCompleted = uiFence >= FRAME_COUNT - 1 ? uiFence - ( FRAME_COUNT - 1 ) : 0;
+        Arena* pArena = FrameArenaRingBeginFrame( &ring, uiIndex, uiCompleted );
+
+        uint32* pCulled = ArenaPushArrayNoZero<uint32>( pArena, 256 );
+        BGASSERT( uiFrame < FRAME_COUNT || pCulled == pFramePtrs[uiIndex],
+                  "Frame arena was not reset." );
+        pFramePtrs[uiIndex] = pCulled;
+        FrameArenaRingEndFrame( &ring, ++uiFence );
+    }
+    printf( "\nRan %llu frames over %u arenas", uiFence, FRAME_COUNT );
+
+    // NOTE(asr): Same flow as the DX12 renderer through a resize. Resize waits for the GPU, copies
+    // the current back buffer's fence into every slot and restarts at whatever index the swap
+    // chain hands back, so the slot values stop matching what the ring recorded.
+    uint64 pSlotFences[FRAME_COUNT] = {};
+    uint64 uiGpuCompleted = uiFence; // The run above has drained
+    uint32 uiBackBuffer = 0;
+    uint32 uiStaleResets = 0;
+    for( uint32 uiFrame = 0; uiFrame < 12; ++uiFrame )
+    {
+        if( uiFrame == 5 )
+        {
+            uiGpuCompleted = uiFence;
+            uint64 const uiCurrentFence = pSlotFences[uiBackBuffer];
+            for( uint64& uiSlotFence : pSlotFences )
+            {
+                uiSlotFence = uiCurrentFence;
+            }
+            uiBackBuffer = 0;
+        }
+
+        // Waiting on the slot fence, then asking the fence how far the GPU really got
+        uiGpuCompleted = MAX( uiGpuCompleted, pSlotFences[uiBackBuffer] );
+        uiStaleResets += ring.uiFenceValues[uiBackBuffer] > uiGpuCompleted;
+        FrameArenaRingBeginFrame( &ring, uiBackBuffer, uiGpuCompleted );
+
+        pSlotFences[uiBackBuffer] = ++uiFence;
+        FrameArenaRingEndFrame( &ring, uiFence );
+        uint64 const uiLagged = uiFence - ( FRAME_COUNT - 1 );
+        uiGpuCompleted = MAX( uiGpuCompleted, uiLagged );
+        uiBackBuffer = ( uiBackBuffer + 1 ) % FRAME_COUNT;
     }
+    BGASSERT( uiStaleResets == 0, "Frame arena reset before its fence after a resize." );
+    printf( "\nResized mid run, stale resets: %u", uiStaleResets );
+    FrameArenaRingRelease( &ring );
+}
+
+void RunTest_DoubleEndedArena()
+{
+    printf( "\n\nTesting Double Ended Arena..." );
+    using namespace Bogus::Core;
+
+    DoubleEndedArena* pArena = DoubleEndedArenaAlloc( { .uiReserveSize = MEGABYTES( 4 ),
+                                                        .uiCommitSize = KILOBYTES( 64 ),
+                                                        .name = "LevelLoad" } );
+
+    // NOTE(asr): Load three "levels", results stay on the bottom and temporaries on the top
+    uint64 const uiLevelMarker = DoubleEndedArenaGetBottomPos( pArena );
+    for( uint32 uiLevel = 0; uiLevel < 3; ++uiLevel )
+    {
+        uint64 const uiTempMarker = DoubleEndedArenaGetTopPos( pArena );
+        uint32* pParsed = DoubleEndedArenaPushTopArray<uint32>( pArena, 64 * 1024 );
+        for( uint32 i = 0; i < 64 * 1024; ++i )
+        {
+            pParsed[i] = i + uiLevel;
+        }
+
+        uint32* pResult = DoubleEndedArenaPushBottomArray<uint32>( pArena, 1024 );
+        for( uint32 i = 0; i < 1024; ++i )
+        {
+            pResult[i] = pParsed[i * 64];
+        }
+        BGASSERT( (uint8*)( pResult + 1024 ) <= (uint8*)pParsed, "Bottom and top overlap." );
+        DoubleEndedArenaPopTopTo( pArena, uiTempMarker );
+    }
+    printf( "\nBottom: %llu, free: %llu, commits: %u", DoubleEndedArenaGetBottomPos( pArena ),
+            DoubleEndedArenaGetFreeSize( pArena ), pArena->uiCommitCount );
+
+    BGASSERT( !DoubleEndedArenaPushTop( pArena, MEGABYTES( 8 ), 8 ), "Overcommit should fail." );
+    DoubleEndedArenaPopBottomTo( pArena, uiLevelMarker );
+    BGASSERT( DoubleEndedArenaGetFreeSize( pArena ) ==
+                  pArena->uiReservedSize - DOUBLE_ENDED_ARENA_HEADER_SIZE,
+              "Markers did not roll back." );
+    DoubleEndedArenaRelease( pArena );
+}
+
+void RunTest_RegionContainers()
+{
+    printf( "\n\nTesting Region Containers..." );
+    using namespace Bogus::Core;
+
+    // NOTE(asr): As HeapVectors these would reserve 100 TB of address space
+    static constexpr uint32 CONTAINER_COUNT = 100000;
+    using ListVector = RegionVector<uint32, 16, 1024>;
+    ListVector* pVectors = new ListVector[CONTAINER_COUNT];
+    for( uint32 i = 0; i < CONTAINER_COUNT; ++i )
+    {
+        for( uint32 j = 0; j < i % 64; ++j )
+        {
+            pVectors[i].push( j );
+        }
+    }
+    RegionStats const stats = RegionGetStats();
+    printf( "\nRegions: %llu, reserved: %llu MB, carved: %llu MB, committed: %llu MB",
+            stats.uiRegionCount, stats.uiReservedSize / MEGABYTES( 1 ),
+            stats.uiCarvedSize / MEGABYTES( 1 ), stats.uiCommittedSize / MEGABYTES( 1 ) );
+    BGASSERT( pVectors[63][62] == 62, "Region vector lost data." );
+    delete[] pVectors;
+
+    RegionElementPool<uint64, 16, 4096> pool;
+    uint32 const uiHandle = pool.Create();
+    pool[uiHandle] = 42;
+    BGASSERT( pool.count() == 1 && pool[uiHandle] == 42, "Region element pool failed." );
+
+    RegionStats const after = RegionGetStats();
+    printf( "\nAfter release, regions: %llu, free: %llu, committed: %llu KB", after.uiRegionCount,
+            after.uiFreeRegionCount, after.uiCommittedSize / KILOBYTES( 1 ) );
+}
+
+void RunTest_SmallVector()
+{
+    printf( "\n\nTesting Small Vector..." );
+    using namespace Bogus::Core;
+
+    RegionStats const before = RegionGetStats();
+    SmallVector<uint32, 8> shortList;
+    for( uint32 i = 0; i < 8; ++i )
+    {
+        shortList.push( i );
+    }
+    BGASSERT( !shortList.spilled(), "Small vector spilled below its inline capacity." );
+    BGASSERT( RegionGetStats().uiRegionCount == before.uiRegionCount, "Inline list took memory." );
+
+    SmallVector<uint32, 8> outlier;
+    for( uint32 i = 0; i < 1000; ++i )
+    {
+        outlier.push( i );
+    }
+    uint32 uiMismatches = 0;
+    for( uint32 i = 0; i < outlier.size(); ++i )
+    {
+        uiMismatches += outlier[i] != i;
+    }
+    printf( "\nInline size: %u, outlier size: %u, spilled: %d, mismatches: %u", shortList.size(),
+            outlier.size(), outlier.spilled(), uiMismatches );
+    printf( "\nsizeof( SmallVector<uint32, 8> ): %llu", (uint64)sizeof( shortList ) );
+}
+
+void RunTest_HashMap()
+{
+    printf( "\n\nTesting Hash Map..." );
+    using namespace Bogus::Core;
+
+    HashMap<uint32, uint32> map;
+    for( uint32 i = 0; i < 100000; ++i )
+    {
+        map.add( i, i * 3 );
+    }
+    for( uint32 i = 0; i < 100000; i += 2 )
+    {
+        map.remove( i );
+    }
+    uint32 uiExists = 0;
+    map.add( 1, 0, &uiExists );
+    BGASSERT( uiExists && *map.find( 1 ) == 3, "Existing key was overwritten." );
+
+    uint32 uiMismatches = 0;
+    for( uint32 i = 0; i < 100000; ++i )
+    {
+        uint32 const* pValue = map.find( i );
+        uiMismatches += ( i & 1 ) ? !pValue || *pValue != i * 3 : pValue != nullptr;
+    }
+    uint32 uiIterated = 0;
+    for( auto& pair : map )
+    {
+        uiIterated += pair.m_Element == pair.m_Key * 3;
+    }
+    printf( "\nSize: %u, capacity: %llu, iterated: %u, mismatches: %u", map.size(), map.capacity(),
+            uiIterated, uiMismatches );
+
+    // NOTE(asr): Token keys hash once when made, lookups never rehash the string
+    Arena* pNames = NEW_ARENA(.name = "HashMapNames" );
+    HashMap<String::HashToken, uint32> names;
+    for( uint32 i = 0; i < 1000; ++i )
+    {
+        char* szName = (char*)ArenaPush( pNames, 32, 1 );
+        int const iLen = snprintf( szName, 32, "Resource_%u", i );
+        names.add( String::HashToken( szName, iLen ), i );
+    }
+    uint32 const* pFound = names.find( String::HashToken( "Resource_42", 11 ) );
+    BGASSERT( pFound && *pFound == 42, "Token lookup failed." );
+    BGASSERT( !names.find( String::HashToken( "Resource_1000", 13 ) ),
+              "Found a key that was never added." );
+    ArenaRelease( pNames );
+}
+
+void RunBench_HashMap()
+{
+    printf( "\n\nBenchmarking Hash Map..." );
+    using namespace Bogus::Core;
+    using Clock = std::chrono::high_resolution_clock;
+    auto Ms = []( Clock::time_point start )
+    { return std::chrono::duration<double, std::milli>( Clock::now() - start ).count(); };
+
+    static constexpr uint32 NUM_KEYS = 8000;
+    uint32* pKeys = new uint32[NUM_KEYS];
+    uint32 uiSeed = 0xc0ffee;
+    for( uint32 i = 0; i < NUM_KEYS; ++i )
+    {
+        uiSeed = uiSeed * 1664525u + 1013904223u;
+        pKeys[i] = uiSeed;
+    }
+
+    uint64 uiSum = 0;
+    Clock::time_point start = Clock::now();
+    {
+        using Uint32MapPair = VectorMapPair<uint32, uint32>;
+        VectorMap<HeapVector<Uint32MapPair>> vectorMap;
+        for( uint32 i = 0; i < NUM_KEYS; ++i )
+        {
+            vectorMap.add( pKeys[i], i );
+        }
+        for( uint32 i = 0; i < NUM_KEYS; ++i )
+        {
+            uiSum += vectorMap.find( pKeys[i] );
+        }
+    }
+    double const fVectorMapMs = Ms( start );
+
+    start = Clock::now();
+    {
+        std::unordered_map<uint32, uint32> stdMap;
+        for( uint32 i = 0; i < NUM_KEYS; ++i )
+        {
+            stdMap.emplace( pKeys[i], i );
+        }
+        for( uint32 r = 0; r < 100; ++r )
+        {
+            for( uint32 i = 0; i < NUM_KEYS; ++i )
+            {
+                uiSum += stdMap.find( pKeys[i] )->second;
+            }
+        }
+    }
+    double const fStdMs = Ms( start );
+
+    start = Clock::now();
+    {
+        HashMap<uint32, uint32> hashMap;
+        for( uint32 i = 0; i < NUM_KEYS; ++i )
+        {
+            hashMap.add( pKeys[i], i );
+        }
+        for( uint32 r = 0; r < 100; ++r )
+        {
+            for( uint32 i = 0; i < NUM_KEYS; ++i )
+            {
+                uiSum += *hashMap.find( pKeys[i] );
+            }
+        }
+    }
+    double const fHashMapMs = Ms( start );
+    delete[] pKeys;
+
+    printf( "\n%u keys, build + lookups (x1 VectorMap, x100 others)", NUM_KEYS );
+    printf( "\nVectorMap: %.2fms, std::unordered_map: %.2fms, HashMap: %.2fms (%llu)",
+            fVectorMapMs, fStdMs, fHashMapMs, uiSum );
+}
+
+void RunTest_ConcurrentQueues()
+{
+    printf( "\n\nTesting Concurrent Queues..." );
+    using namespace Bogus::Core;
+
+    constexpr uint32 NUM_VALUES = 200000;
+    uint32 uiMismatches = 0;
+    {
+        SpscQueue<uint32, 1024> queue;
+        std::thread producer(
+            [&queue]()
+            {
+                for( uint32 i = 0; i < NUM_VALUES; ++i )
+                {
+                    while( !queue.try_push( i ) )
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            } );
+        for( uint32 i = 0; i < NUM_VALUES; ++i )
+        {
+            uint32 uiValue = 0;
+            while( !queue.try_pop( &uiValue ) )
+            {
+                std::this_thread::yield();
+            }
+            uiMismatches += uiValue != i;
+        }
+        producer.join();
+    }
+
+    // NOTE(asr): Values are tagged with their producer, each consumer must see every producer's
+    // values in the order they were pushed
+    constexpr uint32 NUM_THREADS = 4;
+    constexpr uint32 NUM_PER_PRODUCER = NUM_VALUES / NUM_THREADS;
+    StaticMpmcQueue<uint32, 256>* pQueue = new StaticMpmcQueue<uint32, 256>();
+    std::atomic<uint64> uiSum = 0;
+    std::atomic<uint32> uiPopped = 0;
+    std::atomic<uint32> uiOutOfOrder = 0;
+    std::thread threads[NUM_THREADS * 2];
+    for( uint32 t = 0; t < NUM_THREADS; ++t )
+    {
+        threads[t] = std::thread(
+            [pQueue, t]()
+            {
+                for( uint32 i = 0; i < NUM_PER_PRODUCER; ++i )
+                {
+                    while( !pQueue->try_push( ( t << 24 ) | i ) )
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            } );
+        threads[NUM_THREADS + t] = std::thread(
+            [pQueue, &uiSum, &uiPopped, &uiOutOfOrder]()
+            {
+                uint32 pLastSeen[NUM_THREADS] = {};
+                uint64 uiLocalSum = 0;
+                uint32 uiValue = 0;
+                while( uiPopped.load( std::memory_order_relaxed ) < NUM_VALUES )
+                {
+                    if( !pQueue->try_pop( &uiValue ) )
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    uint32 const uiProducer = uiValue >> 24;
+                    uint32 const uiIndex = ( uiValue & 0xffffff ) + 1;
+                    uiOutOfOrder += uiIndex <= pLastSeen[uiProducer];
+                    pLastSeen[uiProducer] = uiIndex;
+                    uiLocalSum += uiValue & 0xffffff;
+                    uiPopped.fetch_add( 1, std::memory_order_relaxed );
+                }
+                uiSum += uiLocalSum;
+            } );
+    }
+    for( std::thread& thread : threads )
+    {
+        thread.join();
+    }
+    delete pQueue;
+
+    uint64 const uiExpectedSum =
+        (uint64)NUM_THREADS * NUM_PER_PRODUCER * ( NUM_PER_PRODUCER - 1 ) / 2;
+    uiMismatches += uiSum.load() != uiExpectedSum;
+    uiMismatches += uiOutOfOrder.load();
+    BGASSERT( uiMismatches == 0, "Concurrent queue lost or reordered values." );
+    printf( "\nPopped: %u, mismatches: %u", uiPopped.load(), uiMismatches );
+}
+
+void RunBench_ConcurrentQueues()
+{
+    printf( "\n\nBenchmarking Concurrent Queues..." );
+    using namespace Bogus::Core;
+    using Clock = std::chrono::high_resolution_clock;
+    auto Ms = []( Clock::time_point start )
+    { return std::chrono::duration<double, std::milli>( Clock::now() - start ).count(); };
+
+    constexpr uint32 NUM_VALUES = 100000;
+
+    // Same hand-off through a mutex guarded queue, the alternative without these
+    struct LockedQueue
+    {
+        bool try_push( uint32 uiValue )
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( queue.count() == 1024 )
+            {
+                return false;
+            }
+            queue.push( uiValue );
+            return true;
+        }
+        bool try_pop( uint32* pOutValue )
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            return queue.pop_n( pOutValue, 1 ) == 1;
+        }
+
+        std::mutex mutex;
+        RegionQueue<uint32> queue;
+    };
+
+    auto Run = [Ms]( auto* pQueue, uint32 uiNumProducers, uint32 uiNumConsumers )
+    {
+        std::atomic<uint32> uiPopped = 0;
+        std::thread threads[16];
+        Clock::time_point const start = Clock::now();
+        for( uint32 t = 0; t < uiNumProducers; ++t )
+        {
+            threads[t] = std::thread(
+                [pQueue, uiNumProducers]()
+                {
+                    for( uint32 i = 0; i < NUM_VALUES / uiNumProducers; ++i )
+                    {
+                        while( !pQueue->try_push( i ) )
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                } );
+        }
+        for( uint32 t = 0; t < uiNumConsumers; ++t )
+        {
+            threads[uiNumProducers + t] = std::thread(
+                [pQueue, &uiPopped, uiNumProducers]()
+                {
+                    uint32 const uiTotal = NUM_VALUES / uiNumProducers * uiNumProducers;
+                    uint32 uiValue = 0;
+                    while( uiPopped.load( std::memory_order_relaxed ) < uiTotal )
+                    {
+                        if( pQueue->try_pop( &uiValue ) )
+                        {
+                            uiPopped.fetch_add( 1, std::memory_order_relaxed );
+                        }
+                        else
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                } );
+        }
+        for( uint32 t = 0; t < uiNumProducers + uiNumConsumers; ++t )
+        {
+            threads[t].join();
+        }
+        return Ms( start );
+    };
+
+    SpscQueue<uint32, 1024>* pSpsc = new SpscQueue<uint32, 1024>();
+    printf( "\n%u values, 1p/1c: SpscQueue %.2fms", NUM_VALUES, Run( pSpsc, 1, 1 ) );
+    delete pSpsc;
+
+    for( uint32 uiThreads = 1; uiThreads <= 4; uiThreads *= 2 )
+    {
+        MpmcQueue<uint32, 1024>* pMpmc = new MpmcQueue<uint32, 1024>();
+        LockedQueue* pLocked = new LockedQueue();
+        double const fMpmcMs = Run( pMpmc, uiThreads, uiThreads );
+        double const fLockedMs = Run( pLocked, uiThreads, uiThreads );
+        printf( "\n%up/%uc: MpmcQueue %.2fms, mutex + Queue %.2fms", uiThreads, uiThreads, fMpmcMs,
+                fLockedMs );
+        delete pLocked;
+        delete pMpmc;
+    }
+    printf( "\nHardware threads: %u", std::thread::hardware_concurrency() );
+}
+
+void RunTest_SortedFlatMap()
+{
+    printf( "\n\nTesting Sorted Flat Map..." );
+    using namespace Bogus::Core;
+    using Uint32MapPair = VectorMapPair<uint32, uint32>;
+
+    SortedFlatMap<RegionVector<Uint32MapPair, 1024, 1 << 16>> map;
+    map.build();
+    BGASSERT( map.begin() == map.end() && !map.find( 0 ), "Empty map found a key." );
+
+    // NOTE(asr): Odd keys only, added in a scrambled order with some duplicates
+    for( uint32 i = 0; i < 10000; ++i )
+    {
+        uint32 const uiKey = ( ( i * 7919 ) % 10000 ) * 2 + 1;
+        map.add( uiKey, uiKey * 3 );
+    }
+    map.add( 1, 0 );
+    map.build();
+
+    uint32 uiMismatches = 0;
+    for( uint32 i = 0; i < 20002; ++i )
+    {
+        uint32 const* pValue = map.find( i );
+        uiMismatches += ( i & 1 ) && i < 20000 ? !pValue || *pValue != i * 3 : pValue != nullptr;
+    }
+
+    uint32 uiIterated = 0;
+    uint32 uiPrevKey = 0;
+    for( auto& pair : map )
+    {
+        uiMismatches += pair.m_Key <= uiPrevKey;
+        uiPrevKey = pair.m_Key;
+        ++uiIterated;
+    }
+
+    // Range [100, 200) visits the odd keys 101..199
+    uint32 uiRangeCount = 0;
+    for( auto it = map.lower_bound( 100 ); it != map.end() && it->m_Key < 200; ++it )
+    {
+        ++uiRangeCount;
+    }
+    printf( "\nSize: %u, iterated: %u, range: %u, mismatches: %u", map.size(), uiIterated,
+            uiRangeCount, uiMismatches );
+}
+
+void RunBench_SortedFlatMap()
+{
+    printf( "\n\nBenchmarking Sorted Flat Map..." );
+    using namespace Bogus::Core;
+    using Clock = std::chrono::high_resolution_clock;
+    using Uint32MapPair = VectorMapPair<uint32, uint32>;
+    auto Ms = []( Clock::time_point start )
+    { return std::chrono::duration<double, std::milli>( Clock::now() - start ).count(); };
+
+    static constexpr uint32 NUM_KEYS = 1 << 18;
+    uint32* pKeys = new uint32[NUM_KEYS];
+    uint32 uiSeed = 0xbadf00d;
+    for( uint32 i = 0; i < NUM_KEYS; ++i )
+    {
+        uiSeed = uiSeed * 1664525u + 1013904223u;
+        pKeys[i] = uiSeed;
+    }
+
+    SortedFlatMap<HeapVector<Uint32MapPair, 4096>> flatMap;
+    Uint32MapPair* pSorted = new Uint32MapPair[NUM_KEYS];
+    for( uint32 i = 0; i < NUM_KEYS; ++i )
+    {
+        flatMap.add( pKeys[i], i );
+        pSorted[i] = Uint32MapPair( pKeys[i], i );
+    }
+    flatMap.build();
+    std::sort( pSorted, pSorted + NUM_KEYS, []( Uint32MapPair const& a, Uint32MapPair const& b )
+               { return a.m_Key < b.m_Key; } );
+
+    uint64 uiSum = 0;
+    Clock::time_point start = Clock::now();
+    for( uint32 i = 0; i < NUM_KEYS; ++i )
+    {
+        uint32 const uiKey = pKeys[( i * 7919 ) % NUM_KEYS];
+        Uint32MapPair const* pPair = std::lower_bound(
+            pSorted, pSorted + NUM_KEYS, uiKey,
+            []( Uint32MapPair const& pair, uint32 uiKey ) { return pair.m_Key < uiKey; } );
+        uiSum += pPair->m_Element;
+    }
+    double const fBinaryMs = Ms( start );
+
+    start = Clock::now();
+    for( uint32 i = 0; i < NUM_KEYS; ++i )
+    {
+        uiSum += *flatMap.find( pKeys[( i * 7919 ) % NUM_KEYS] );
+    }
+    double const fFlatMapMs = Ms( start );
+    delete[] pSorted;
+    delete[] pKeys;
+
+    printf( "\n%u keys, %u lookups", flatMap.size(), NUM_KEYS );
+    printf( "\nstd::lower_bound: %.2fms, SortedFlatMap: %.2fms (%llu)", fBinaryMs, fFlatMapMs,
+            uiSum );
+}
+
+void RunTest_VectorMap()
+{
+    using namespace Bogus::Core;
+    using Uint32MapPair = Bogus::Core::VectorMapPair<uint32, uint32>;
+    using Uint32MapPairVector = Bogus::Core::Vector<Bogus::Core::VectorPolicyArena<Uint32MapPair>>;
+    using Uint32Map = Bogus::Core::VectorMap<Uint32MapPairVector>;
+
+    Uint32Map myMap;
+    myMap.add( 0, 69 );
+    myMap.add( 1, 420 );
+    myMap.add( 2, 911 );
+    myMap.add( Bogus::Core::String::CalcHash( "Key1" ), 1234 );
+
+    uint32 uiCount = 4;
+    printf( "\n\nUint32Map: %d", uiCount );
+    for( Uint32MapPair const& Pair : myMap )
+    {
+        printf( "\n[%u]: %u", Pair.m_Key, Pair.m_Element );
+    }
+}
+
+void RunTest_ElementPoolHandles()
+{
+    printf( "\n\nTesting Element Pool Handles..." );
+    using namespace Bogus::Core;
+    using Clock = std::chrono::high_resolution_clock;
+    auto Ms = []( Clock::time_point start )
+    { return std::chrono::duration<double, std::milli>( Clock::now() - start ).count(); };
+
+    constexpr uint32 NUM_HANDLES = 100000;
+    uint32* pHandles = new uint32[NUM_HANDLES];
+    uint32* pDenseHandles = new uint32[NUM_HANDLES];
+    ElementPool<uint64> pool;
+    DenseElementPool<uint64> densePool;
+    for( uint32 i = 0; i < NUM_HANDLES; ++i )
+    {
+        pHandles[i] = pool.Create();
+        pool[pHandles[i]] = i;
+        pDenseHandles[i] = densePool.Create();
+        densePool[pDenseHandles[i]] = i;
+    }
+
+    // NOTE(asr): Heavy churn, 9 in 10 die and their slots get reused by new elements
+    uint32 uiMismatches = 0;
+    for( uint32 i = 0; i < NUM_HANDLES; ++i )
+    {
+        if( i % 10 )
+        {
+            pool.Destroy( pHandles[i] );
+            densePool.Destroy( pDenseHandles[i] );
+        }
+    }
+    uint32 const uiStaleHandle = pHandles[NUM_HANDLES - 1]; // Destroyed last, reused first
+    uint32 const uiReusedHandle = pool.Create();
+    pool[uiReusedHandle] = 0;
+    uiMismatches += ( uiReusedHandle & ELEMENT_POOL_INDEX_MASK ) !=
+                    ( uiStaleHandle & ELEMENT_POOL_INDEX_MASK );
+    uiMismatches += pool.TryGet( uiStaleHandle ) != nullptr || !pool.TryGet( uiReusedHandle );
+    uiMismatches += densePool.TryGet( pDenseHandles[1] ) != nullptr;
+    pool.Destroy( uiReusedHandle );
+
+    for( uint32 i = 0; i < NUM_HANDLES; i += 10 )
+    {
+        uiMismatches += *pool.Get( pHandles[i] ) != i || *densePool.Get( pDenseHandles[i] ) != i;
+    }
+
+    uint64 uiSum = 0;
+    Clock::time_point start = Clock::now();
+    pool.ForEachElement( [&uiSum]( uint32, uint64* pValue ) { uiSum += *pValue; } );
+    double const fSparseMs = Ms( start );
+
+    uint64 uiDenseSum = 0;
+    start = Clock::now();
+    for( uint64 const uiValue : densePool )
+    {
+        uiDenseSum += uiValue;
+    }
+    double const fDenseMs = Ms( start );
+    uiMismatches += uiSum != uiDenseSum;
+    delete[] pDenseHandles;
+    delete[] pHandles;
+
+    printf( "\nLive: %u/%u, mismatches: %u", densePool.count(), pool.count(), uiMismatches );
+    printf( "\nIterating 10%% live, sparse: %.3fms, dense: %.3fms", fSparseMs, fDenseMs );
+}
+
+void RunTest_ConcurrentElementPool()
+{
+    printf( "\n\nTesting Concurrent Element Pool..." );
+    using namespace Bogus::Core;
+    using Clock = std::chrono::high_resolution_clock;
+    auto Ms = []( Clock::time_point start )
+    { return std::chrono::duration<double, std::milli>( Clock::now() - start ).count(); };
+
+    constexpr uint32 NUM_THREADS = 4;
+    constexpr uint32 NUM_OPS = 50000;
+    constexpr uint32 NUM_KEPT = 256;
+    struct Job
+    {
+        uint32 uiThread;
+        uint32 uiSerial;
+    };
+
+    // NOTE(asr): Every thread churns through its own handles, the survivors must still hold what
+    // their thread wrote and every destroyed handle must stay dead
+    auto Churn = [&]( auto* pPool, auto Create, auto Destroy, uint32* pOutMismatches )
+    {
+        std::atomic<uint32> uiMismatches = 0;
+        std::thread threads[NUM_THREADS];
+        for( uint32 t = 0; t < NUM_THREADS; ++t )
+        {
+            threads[t] = std::thread(
+                [=, &uiMismatches]()
+                {
+                    uint32 pHandles[NUM_KEPT];
+                    uint32 uiStale = max_uint32;
+                    for( uint32 i = 0; i < NUM_OPS; ++i )
+                    {
+                        uint32 const uiSlot = i % NUM_KEPT;
+                        if( i >= NUM_KEPT )
+                        {
+                            Job* pJob = pPool->TryGet( pHandles[uiSlot] );
+                            uiMismatches += !pJob || pJob->uiThread != t ||
+                                            pJob->uiSerial != i - NUM_KEPT;
+                            Destroy( pHandles[uiSlot] );
+                            uiStale = pHandles[uiSlot];
+                        }
+                        pHandles[uiSlot] = Create();
+                        *pPool->Get( pHandles[uiSlot] ) = { t, i };
+                    }
+                    uiMismatches += uiStale != max_uint32 && pPool->TryGet( uiStale ) != nullptr;
+                } );
+        }
+        for( std::thread& thread : threads )
+        {
+            thread.join();
+        }
+        *pOutMismatches += uiMismatches.load();
+    };
+
+    uint32 uiMismatches = 0;
+    ConcurrentElementPool<Job>* pPool = new ConcurrentElementPool<Job>();
+    Clock::time_point start = Clock::now();
+    Churn(
+        pPool, [pPool]() { return pPool->Create(); },
+        [pPool]( uint32 uiHandle ) { pPool->Destroy( uiHandle ); }, &uiMismatches );
+    double const fConcurrentMs = Ms( start );
+    uint32 uiLive = 0;
+    pPool->ForEachElement( [&uiLive]( uint32, Job* ) { ++uiLive; } );
+    uiMismatches += uiLive != NUM_THREADS * NUM_KEPT || pPool->count() != uiLive;
+    printf( "\nLive: %u, commits: %u", pPool->count(), pPool->commit_count() );
+    delete pPool;
+
+    std::mutex mutex;
+    ElementPool<Job>* pLockedPool = new ElementPool<Job>();
+    struct LockedPool
+    {
+        Job* TryGet( uint32 uiHandle )
+        {
+            std::lock_guard<std::mutex> lock( *pMutex );
+            return pPool->TryGet( uiHandle );
+        }
+        Job* Get( uint32 uiHandle )
+        {
+            std::lock_guard<std::mutex> lock( *pMutex );
+            return pPool->Get( uiHandle );
+        }
+
+        std::mutex* pMutex;
+        ElementPool<Job>* pPool;
+    } lockedPool = { &mutex, pLockedPool };
+    start = Clock::now();
+    Churn(
+        &lockedPool,
+        [&]()
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            return pLockedPool->Create();
+        },
+        [&]( uint32 uiHandle )
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            pLockedPool->Destroy( uiHandle );
+        },
+        &uiMismatches );
+    double const fLockedMs = Ms( start );
+    delete pLockedPool;
+
+    BGASSERT( uiMismatches == 0, "Concurrent pool handed out a live slot twice." );
+    printf( "\n%u threads x %u ops, ConcurrentElementPool: %.2fms, mutex + ElementPool: %.2fms",
+            NUM_THREADS, NUM_OPS, fConcurrentMs, fLockedMs );
+    printf( "\nMismatches: %u", uiMismatches );
+}
+
+void RunTest_ElementPoolCompact()
+{
+    printf( "\n\nTesting Element Pool Compact..." );
+    using namespace Bogus::Core;
+
+    // NOTE(asr): Elements hold their id, pHandles is the external table the remaps are applied to
+    constexpr uint32 NUM_ELEMENTS = 100000;
+    constexpr uint32 MOVES_PER_FRAME = 1000;
+    uint32* pHandles = new uint32[NUM_ELEMENTS];
+    ElementPool<uint64>* pPool = new ElementPool<uint64>();
+    for( uint32 i = 0; i < NUM_ELEMENTS; ++i )
+    {
+        pHandles[i] = pPool->Create();
+        ( *pPool )[pHandles[i]] = i;
+    }
+    for( uint32 i = 0; i < NUM_ELEMENTS; ++i )
+    {
+        if( i % 10 )
+        {
+            pPool->Destroy( pHandles[i] );
+            pHandles[i] = ElementPool<uint64>::INVALID;
+        }
+    }
+
+    uint32 const uiCommittedBefore = pPool->m_Vec.size_committed();
+    uint32 const uiStaleHandle = pHandles[NUM_ELEMENTS - 10];
+    ElementPoolRemap pRemaps[MOVES_PER_FRAME];
+    uint32 uiFrames = 0;
+    uint32 uiMoves = 0;
+    while( uint32 const uiFrameMoves = pPool->Compact( MOVES_PER_FRAME, pRemaps ) )
+    {
+        for( uint32 i = 0; i < uiFrameMoves; ++i )
+        {
+            pHandles[*pPool->Get( pRemaps[i].uiNewHandle )] = pRemaps[i].uiNewHandle;
+        }
+        uiMoves += uiFrameMoves;
+        ++uiFrames;
+
+        // Work keeps going between slices
+        uint32 const uiHandle = pPool->Create();
+        ( *pPool )[uiHandle] = NUM_ELEMENTS;
+        pPool->Destroy( uiHandle );
+    }
+
+    uint32 uiMismatches = !pPool->compacted() || pPool->TryGet( uiStaleHandle ) != nullptr;
+    for( uint32 i = 0; i < NUM_ELEMENTS; i += 10 )
+    {
+        uint64 const* pValue = pPool->TryGet( pHandles[i] );
+        uiMismatches += !pValue || *pValue != i;
+    }
+    printf( "\nMoves: %u over %u frames, size: %u, committed: %u -> %u elements, mismatches: %u",
+            uiMoves, uiFrames, pPool->m_Vec.size(), uiCommittedBefore,
+            pPool->m_Vec.size_committed(), uiMismatches );
+
+    // NOTE(asr): Growing while compacting every frame must not give back what it just committed
+    uint32 const uiDecommitsBefore = pPool->m_Vec.m_pArena->uiDecommitCount;
+    for( uint32 uiFrame = 0; uiFrame < 50; ++uiFrame )
+    {
+        for( uint32 i = 0; i < 100; ++i )
+        {
+            pPool->Create();
+        }
+        pPool->Compact( MOVES_PER_FRAME, pRemaps );
+    }
+    uint32 const uiGrowDecommits = pPool->m_Vec.m_pArena->uiDecommitCount - uiDecommitsBefore;
+    BGASSERT( uiGrowDecommits == 0, "Compact decommitted a growing pool." );
+    printf( "\nDecommits while growing: %u", uiGrowDecommits );
+    delete pPool;
+    delete[] pHandles;
+}
+
+void RunTest_SoA()
+{
+    printf( "\n\nTesting SoA Containers..." );
+    using namespace Bogus::Core;
+    using Clock = std::chrono::high_resolution_clock;
+    auto Ms = []( Clock::time_point start )
+    { return std::chrono::duration<double, std::milli>( Clock::now() - start ).count(); };
+
+    struct Vec3
+    {
+        float x, y, z;
+    };
+    struct Particle
+    {
+        Vec3 position;
+        Vec3 velocity;
+        float fAge;
+        uint32 uiColor;
+        uint64 uiUserData[4];
+    };
+    enum
+    {
+        ePosition,
+        eVelocity,
+        eAge,
+        eColor,
+        eUserData,
+    };
+    struct UserData
+    {
+        uint64 uiData[4];
+    };
+
+    constexpr uint32 NUM_PARTICLES = 1 << 18;
+    SoAVector<Vec3, Vec3, float, uint32, UserData> particles( NUM_PARTICLES );
+    HeapVector<Particle> aosParticles;
+    for( uint32 i = 0; i < NUM_PARTICLES; ++i )
+    {
+        Vec3 const position = { (float)i, 0.0f, 0.0f };
+        Vec3 const velocity = { 1.0f, 2.0f, 3.0f };
+        particles.push( position, velocity, 0.0f, i, {} );
+        aosParticles.push( { position, velocity, 0.0f, i, {} } );
+    }
+    uint32 uiMismatches = ( (uint64)particles.column<eVelocity>() % SOA_COLUMN_ALIGNMENT ) != 0;
+
+    // NOTE(asr): The age pass only streams one float column
+    Clock::time_point start = Clock::now();
+    std::span<float> ages = particles.span<eAge>();
+    for( float& fAge : ages )
+    {
+        fAge += 0.016f;
+    }
+    double const fSoAMs = Ms( start );
+
+    start = Clock::now();
+    for( Particle& particle : aosParticles )
+    {
+        particle.fAge += 0.016f;
+    }
+    double const fAoSMs = Ms( start );
+
+    // Remove the even colors, the last row swaps into the hole so it gets checked next
+    for( uint32 i = 0; i < particles.size(); )
+    {
+        if( particles.get<eColor>( i ) & 1 )
+        {
+            ++i;
+        }
+        else
+        {
+            particles.remove_swap( i );
+        }
+    }
+    for( uint32 i = 0; i < particles.size(); ++i )
+    {
+        uint32 const uiColor = particles.get<eColor>( i );
+        uiMismatches += particles.get<ePosition>( i ).x != (float)uiColor;
+        uiMismatches += uiColor & 1 ? 0 : 1;
+    }
+    particles.shrink_to_fit();
+
+    SoAElementPool<Vec3, float> pool;
+    uint32 const uiFirst = pool.Create( { 1.0f, 2.0f, 3.0f }, 10.0f );
+    uint32 const uiSecond = pool.Create( { 4.0f, 5.0f, 6.0f }, 20.0f );
+    uint32 const uiThird = pool.Create( { 7.0f, 8.0f, 9.0f }, 30.0f );
+    pool.Destroy( uiFirst );
+    uint32 const uiReused = pool.Create( { 0.0f, 0.0f, 0.0f }, 40.0f );
+    uiMismatches += pool.IsValid( uiFirst ) || pool.TryGet<0>( uiFirst ) != nullptr;
+    uiMismatches += pool.Get<1>( uiSecond ) != 20.0f || pool.Get<0>( uiThird ).z != 9.0f;
+    uiMismatches += pool.Get<1>( uiReused ) != 40.0f;
+    float fSum = 0.0f;
+    for( float const fValue : pool.span<1>() )
+    {
+        fSum += fValue;
+    }
+    uiMismatches += fSum != 90.0f || pool.count() != 3;
+
+    printf( "\nRows left: %u, pool rows: %u, mismatches: %u", particles.size(), pool.count(),
+            uiMismatches );
+    printf( "\nAge pass over %u particles, SoA: %.3fms, AoS: %.3fms", NUM_PARTICLES, fSoAMs,
+            fAoSMs );
 }
 
 int main()
@@ -305,8 +1869,36 @@ int main()
     RunTest_VectorMap();
     RunTest_VectorStatic();
     RunTest_Arena();
+    RunTest_ArenaLargePages();
+    RunTest_ScratchArena();
+    RunTest_ArenaDecommit();
+    RunTest_ArenaChained();
+    RunTest_ConcurrentArena();
+    RunTest_ArenaRegistry();
+    RunTest_Slab();
+    RunTest_Tlsf();
+    RunTest_ArenaCache();
+    RunTest_ArenaKnownZero();
+    RunTest_ArenaCommitGrowth();
+    RunTest_ArenaNuma();
+    RunTest_PersistentArena();
+    RunTest_FrameArenaRing();
+    RunTest_DoubleEndedArena();
+    RunTest_RegionContainers();
+    RunTest_SmallVector();
+    RunTest_HashMap();
+    RunBench_HashMap();
+    RunTest_SortedFlatMap();
+    RunBench_SortedFlatMap();
+    RunTest_ConcurrentQueues();
+    RunBench_ConcurrentQueues();
     RunTest_VectorHeap();
     RunTest_QueueHeap();
+    RunTest_QueueRing();
     RunTest_ElementPool();
+    RunTest_ElementPoolHandles();
+    RunTest_ElementPoolCompact();
+    RunTest_ConcurrentElementPool();
+    RunTest_SoA();
     getchar();
 }
@@ -1,5 +1,6 @@
 #ifndef CORE_ARENA_H
 #define CORE_ARENA_H
+#include "Core_Memory.h"
 #include "Core_String.h"
 #include "Globals.h"
 
@@ -9,6 +10,17 @@ namespace Core
 {
 static constexpr uint64 ARENA_DEFAULT_RESERVE_SIZE = MEGABYTES( 64 );
 static constexpr uint64 ARENA_DEFAULT_COMMIT_SIZE = KILOBYTES( 64 );
+static constexpr uint64 ARENA_DEFAULT_MAX_COMMIT_STEP = MEGABYTES( 8 );
+static constexpr uint32 ARENA_SCRATCH_COUNT = 2;
+static constexpr uint64 ARENA_DECOMMIT_DISABLED = max_uint64;
+static constexpr uint32 ARENA_DEFAULT_DECOMMIT_DECAY_SHIFT = 3;
+
+enum : uint32
+{
+    eArenaFlag_None = 0,
+    eArenaFlag_Chained = 1 << 0,   // Chain new reserved blocks instead of failing when full
+    eArenaFlag_NoRecycle = 1 << 1, // Bypass the reservation cache, see ArenaCacheParams
+};
 
 // ------------------------------------------------------
 struct ArenaAllocParams
@@ -16,16 +28,58 @@ struct ArenaAllocParams
     uint64 uiReserveSize = ARENA_DEFAULT_RESERVE_SIZE;
     uint64 uiCommitSize = ARENA_DEFAULT_COMMIT_SIZE;
     String::Buffer<128> name;
+    uint32 uiFlags = Memory::eMemFlag_None; // Memory::eMemFlag_* passed to Reserve/Commit
+
+    // NOTE(asr): Pops decommit pages above MAX( threshold, decayed high-water ). Each pop moves
+    // the high-water 1/2^shift of the way down to the new position, so oscillating workloads
+    // keep their commit instead of thrashing.
+    uint64 uiDecommitThreshold = ARENA_DECOMMIT_DISABLED;
+    uint32 uiDecommitDecayShift = ARENA_DEFAULT_DECOMMIT_DECAY_SHIFT;
+    uint32 uiArenaFlags = eArenaFlag_None; // eArenaFlag_*
+
+    // NOTE(asr): Each commit grows by the size already committed, clamped between uiCommitSize and
+    // this, so bulk growth takes O(log n) commits. Set it to uiCommitSize for fixed steps.
+    uint64 uiMaxCommitStep = ARENA_DEFAULT_MAX_COMMIT_STEP;
+
+    // NOTE(asr): Node the pages are placed on when first touched, or Memory::NUMA_NODE_INTERLEAVE.
+    // Placed arenas bypass the reservation cache since cached blocks carry no policy.
+    int32 iNumaNode = Memory::NUMA_NODE_ANY;
 };
 
 // ------------------------------------------------------
+// NOTE(asr): Chained arenas link blocks through pPrev and address them with a global position,
+// uiChainBasePos being the global position of a block's first byte. The first block is the
+// handle users hold and pCurrent points at the block being pushed to. Chained blocks are sized to
+// Memory::GetReservedSize since Reserve rounds up to it anyway, so each block uses all the address
+// space it takes and long chains grow a gigabyte at a time (large pages at a time for HugeTLB).
 struct alignas( 128 ) Arena
 {
     ArenaAllocParams initParams;
+    Arena* pCurrent = nullptr;
+    Arena* pPrev = nullptr;
+    uint64 uiChainBasePos = 0;
     uint64 uiBasePos = 0;
     uint64 uiPos = 0;
     uint64 uiCommittedSize = 0;
     uint64 uiReservedSize = 0;
+    uint64 uiHighWaterPos = 0;
+    uint64 uiZeroPos = 0; // Committed memory at or above this is untouched and known to be zero
+    uint32 uiCommitCount = 0;
+    uint32 uiDecommitCount = 0;
+
+    // NOTE(asr): Instrumentation, kept on the handle for chained arenas. See Core_ArenaRegistry.h
+    uint64 uiPeakPos = 0;
+    uint64 uiPushCount = 0;
+    // Totals over the chained blocks past the handle, kept by the owner so the registry never
+    // walks blocks that the owner may free
+    uint64 uiChainedPos = 0; // Global position while pCurrent is a chained block
+    uint64 uiChainedCommittedSize = 0;
+    uint64 uiChainedReservedSize = 0;
+    uint32 uiChainedCommitCount = 0;
+    uint32 uiChainedDecommitCount = 0;
+    uint32 uiChainedBlockCount = 0;
+    Arena* pRegistryPrev = nullptr;
+    Arena* pRegistryNext = nullptr;
 };
 static constexpr uint32 ARENA_HEADER_SIZE = sizeof( Arena );
 
@@ -40,10 +94,70 @@ uint64 ArenaGetPos( Arena* pArena );
 uint8* ArenaGetBegin( Arena* pArena );
 
 uint8* ArenaPush( Arena* pArena, uint64 uiSize, uint64 uiAlignment );
+uint8* ArenaPush( Arena* pArena, uint64 uiSize, uint64 uiAlignment, uint64* pOutDirtySize );
+// Only clears the part of the block that was used since it was committed
+uint8* ArenaPushZero( Arena* pArena, uint64 uiSize, uint64 uiAlignment );
 
 void ArenaPopTo( Arena* pArena, uint64 uiPos );
 void ArenaPop( Arena* pArena, uint64 uiSize );
 void ArenaClear( Arena* pArena );
+// Decommits every page above the position, regardless of uiDecommitThreshold
+void ArenaDecommitUnused( Arena* pArena );
+
+// ------------------------------------------------------
+// NOTE(asr): Released arenas without memory flags park their reservation in a process wide cache
+// keyed by reserve size rounded up to a power of two, and ArenaAlloc takes from it before asking
+// the OS. Up to uiMaxRetainedCommit bytes stay committed so short lived arenas cost no syscalls at
+// all. The rounding only picks the cache class, uiReservedSize stays the size that was asked for.
+static constexpr uint32 ARENA_CACHE_MAX_PER_CLASS = 32;
+
+struct ArenaCacheParams
+{
+    uint32 uiMaxPerClass = 8;
+    uint64 uiMaxRetainedCommit = MEGABYTES( 1 );
+};
+
+struct ArenaCacheStats
+{
+    uint64 uiHits = 0;
+    uint64 uiMisses = 0;
+    uint64 uiCachedCount = 0;
+    uint64 uiCachedCommittedSize = 0;
+};
+
+void ArenaCacheConfigure( ArenaCacheParams const& params );
+ArenaCacheStats ArenaCacheGetStats();
+void ArenaCacheTrim(); // Releases every cached reservation to the OS
+
+// ------------------------------------------------------
+// Restores the arena position on destruction
+struct ArenaTemp
+{
+    ArenaTemp( Arena* pInArena ) : pArena( pInArena ), uiPos( ArenaGetPos( pInArena ) ) {}
+    ~ArenaTemp() { ArenaPopTo( pArena, uiPos ); }
+    ArenaTemp( ArenaTemp const& ) = delete;
+    ArenaTemp& operator=( ArenaTemp const& ) = delete;
+
+    Arena* pArena;
+    uint64 uiPos;
+};
+
+// ------------------------------------------------------
+// Per-thread scratch arenas. Pass every arena the caller may be allocating its results from so
+// the scratch returned is guaranteed to be a different one.
+ArenaTemp GetScratch( Arena* const* ppConflicts, uint32 uiConflictCount );
+template <typename... tArenas> ArenaTemp GetScratch( tArenas*... pConflicts )
+{
+    Arena* const conflicts[] = { nullptr, pConflicts... };
+    return GetScratch( conflicts + 1, sizeof...( pConflicts ) );
+}
+void ReleaseScratch();
+
+// ------------------------------------------------------
+// Per-thread arena placed on the NUMA node the calling thread runs on when first requested.
+// Worker threads should be pinned for the placement to stay meaningful.
+Arena* GetLocalNodeArena();
+void ReleaseLocalNodeArena();
 
 template <typename T>
 T* ArenaPushArrayNoZeroAligned( Arena* pArena, uint32 uiCount, uint64 uiAlignment )
@@ -54,9 +168,7 @@ T* ArenaPushArrayNoZeroAligned( Arena* pArena, uint32 uiCount, uint64 uiAlignmen
 template <typename T> T* ArenaPushArrayAligned( Arena* pArena, uint32 uiCount, uint64 uiAlignment )
 {
     uint64 const uiTotalSize = sizeof( T ) * uiCount;
-    T* pData = reinterpret_cast<T*>( ArenaPush( pArena, uiTotalSize, uiAlignment ) );
-    memset( pData, 0, uiTotalSize );
-    return pData;
+    return reinterpret_cast<T*>( ArenaPushZero( pArena, uiTotalSize, uiAlignment ) );
 }
 
 template <typename T> T* ArenaPushArrayNoZero( Arena* pArena, uint32 uiCount )
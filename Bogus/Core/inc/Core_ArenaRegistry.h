@@ -0,0 +1,48 @@
+#ifndef CORE_ARENAREGISTRY_H
+#define CORE_ARENAREGISTRY_H
+#include "Core_Arena.h"
+#include "Core_String.h"
+#include "Globals.h"
+
+namespace Bogus
+{
+namespace Core
+{
+enum class ArenaDumpFormat
+{
+    JSON,
+    CSV,
+};
+
+// ------------------------------------------------------
+// Snapshot of an arena, summed over every block for chained arenas
+struct ArenaStats
+{
+    String::Buffer<128> name;
+    uint64 uiPos = 0;
+    uint64 uiPeakPos = 0;
+    uint64 uiCommittedSize = 0;
+    uint64 uiReservedSize = 0;
+    uint64 uiPushCount = 0;
+    uint32 uiCommitCount = 0;
+    uint32 uiDecommitCount = 0;
+    uint32 uiBlockCount = 0;
+};
+
+// NOTE(asr): Every Arena from ArenaAlloc is registered until ArenaRelease. Stats only read the
+// handle, which stays mapped while registered, never the chained blocks its owner may free. Stats
+// of arenas owned by other threads are read without synchronization and are only approximate.
+void ArenaRegistryAdd( Arena* pArena );
+void ArenaRegistryRemove( Arena* pArena );
+
+ArenaStats ArenaGetStats( Arena* pArena );
+
+// Returns the number of live arenas, fills up to uiMaxCount stats
+uint32 ArenaRegistryGetStats( ArenaStats* pOutStats, uint32 uiMaxCount );
+
+// snprintf style, returns the length needed excluding the null terminator
+uint64 ArenaRegistryDump( char* pBuffer, uint64 uiBufferSize, ArenaDumpFormat format );
+
+} // namespace Core
+} // namespace Bogus
+#endif
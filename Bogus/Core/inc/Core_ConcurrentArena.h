@@ -0,0 +1,48 @@
+#ifndef CORE_CONCURRENTARENA_H
+#define CORE_CONCURRENTARENA_H
+#include "Core_Arena.h"
+#include "Globals.h"
+#include <atomic>
+
+namespace Bogus
+{
+namespace Core
+{
+// NOTE(asr): Every push reserves a multiple of this so the position always stays aligned, and
+// pushes of at most this alignment take the fast path, a single fetch_add with no padding.
+static constexpr uint64 CONCURRENT_ARENA_MIN_ALIGNMENT = 16;
+
+// ------------------------------------------------------
+// Bump arena that many threads can push into at once. Growth is committed by whichever thread
+// wins the commit lock, the rest wait for it. Pop/Clear are not safe while others push.
+struct alignas( 128 ) ConcurrentArena
+{
+    ArenaAllocParams initParams;
+    uint64 uiBasePos = 0;
+    uint64 uiReservedSize = 0;
+    alignas( 64 ) std::atomic<uint64> uiPos = 0;
+    alignas( 64 ) std::atomic<uint64> uiCommittedSize = 0;
+    std::atomic<uint32> uiCommitLock = 0;
+    std::atomic<uint32> uiCommitCount = 0;
+};
+static constexpr uint32 CONCURRENT_ARENA_HEADER_SIZE = sizeof( ConcurrentArena );
+
+ConcurrentArena* ConcurrentArenaAlloc( ArenaAllocParams const& params );
+void ConcurrentArenaRelease( ConcurrentArena* pArena );
+
+uint64 ConcurrentArenaGetPos( ConcurrentArena* pArena );
+uint8* ConcurrentArenaGetBegin( ConcurrentArena* pArena );
+
+uint8* ConcurrentArenaPush( ConcurrentArena* pArena, uint64 uiSize, uint64 uiAlignment );
+void ConcurrentArenaClear( ConcurrentArena* pArena );
+
+template <typename T>
+T* ConcurrentArenaPushArrayNoZero( ConcurrentArena* pArena, uint32 uiCount )
+{
+    return reinterpret_cast<T*>(
+        ConcurrentArenaPush( pArena, sizeof( T ) * uiCount, MAX( 8, ALIGNOF( T ) ) ) );
+}
+
+} // namespace Core
+} // namespace Bogus
+#endif
@@ -0,0 +1,252 @@
+#ifndef CORE_CONCURRENTPOOL_H
+#define CORE_CONCURRENTPOOL_H
+#include "Core_Assert.h"
+#include "Core_Memory.h"
+#include "Core_Utility.h"
+#include "Core_Vector.h"
+#include "Globals.h"
+#include <atomic>
+#include <new>
+#include <thread>
+
+namespace Bogus
+{
+namespace Core
+{
+
+struct ConcurrentPoolSlot
+{
+    std::atomic<uint32> uiGeneration = 0; // Odd while alive, same scheme as ElementPoolSlot
+    std::atomic<uint32> uiNextFree = 0;
+};
+
+// -----------------------------------------------------------------------
+// -----------------------------------------------------------------------
+// NOTE(asr): ElementPool that any number of threads can Create/Destroy/Get on at once, with the
+// same handles. Slots and elements live in one reservation sized for uiMaxCapacity and committed
+// as the high water grows, so elements never move. Dead slots go on a lock free stack whose head
+// packs a tag that every push and pop bumps, so a head that was popped and pushed back in between
+// (ABA) fails the CAS. Destroy claims the slot by moving its generation with a CAS, so racing
+// destroys of one handle only succeed once. Get is safe against Create/Destroy of other handles,
+// keeping an element alive while it is used is up to the caller.
+template <typename tElemType, uint32 uiGrowthSize = 64,
+          uint64 uiMaxCapacity = ARENA_DEFAULT_RESERVE_SIZE / sizeof( tElemType )>
+struct ConcurrentElementPool
+{
+    using ELEMTYPE = tElemType;
+    static constexpr uint32 INVALID = max_uint32;
+    static constexpr uint32 MAX_SLOTS =
+        uiMaxCapacity < ELEMENT_POOL_MAX_SLOTS ? (uint32)uiMaxCapacity : ELEMENT_POOL_MAX_SLOTS;
+
+    ConcurrentElementPool()
+    {
+        uint64 const uiPageSize = Memory::GetPageSize();
+        m_uiElementsOffset = ALIGNUP_POW2( MAX_SLOTS * sizeof( ConcurrentPoolSlot ), uiPageSize );
+        m_uiReservedSize = m_uiElementsOffset + ALIGNUP_POW2( MAX_SLOTS * sizeof( ELEMTYPE ),
+                                                              uiPageSize );
+        m_pMem = (uint8*)Memory::Reserve( m_uiReservedSize );
+        BGASSERT( m_pMem, "Failed to Reserve pMemory" );
+    }
+    ConcurrentElementPool( ConcurrentElementPool const& ) = delete;
+    ConcurrentElementPool& operator=( ConcurrentElementPool const& ) = delete;
+    ~ConcurrentElementPool()
+    {
+        if( m_pMem )
+        {
+            Memory::Release( m_pMem, m_uiReservedSize );
+        }
+    }
+
+    // Not synchronized with concurrent Destroy, func( uiHandle, pElement )
+    template <typename tFunc> void ForEachElement( tFunc func )
+    {
+        // NOTE(asr): Committed slots past the high water are never alive, so no need to clamp
+        uint32 const uiSlotCount = m_uiCommittedCount.load( std::memory_order_acquire );
+        for( uint32 i = 0; i < uiSlotCount; ++i )
+        {
+            uint32 const uiGeneration = pSlots()[i].uiGeneration.load( std::memory_order_acquire );
+            if( uiGeneration & 1 )
+            {
+                func( MakeHandle( uiGeneration, i ), &pElements()[i] );
+            }
+        }
+    }
+
+    uint32 Create()
+    {
+        uint32 uiIndex = PopFree();
+        if( uiIndex == INVALID )
+        {
+            uiIndex = m_uiSlotCount.fetch_add( 1, std::memory_order_relaxed );
+            if( uiIndex >= MAX_SLOTS || !m_pMem )
+            {
+                BGASSERT( 0, "ConcurrentElementPool ran out of memory." );
+                return INVALID;
+            }
+            CommitTo( uiIndex + 1 );
+        }
+
+        // NOTE(asr): The slot is ours until its generation says alive, publish after constructing
+        ConcurrentPoolSlot& slot = pSlots()[uiIndex];
+        new( &pElements()[uiIndex] ) ELEMTYPE();
+        uint32 const uiGeneration = slot.uiGeneration.load( std::memory_order_relaxed ) + 1;
+        slot.uiGeneration.store( uiGeneration, std::memory_order_release );
+        m_uiCount.fetch_add( 1, std::memory_order_relaxed );
+        return MakeHandle( uiGeneration, uiIndex );
+    }
+
+    bool Destroy( uint32 uiHandle )
+    {
+        uint32 const uiIndex = uiHandle & ELEMENT_POOL_INDEX_MASK;
+        if( uiIndex >= m_uiCommittedCount.load( std::memory_order_acquire ) )
+        {
+            BGASSERT( 0, "Bad Handle passed in to ConcurrentElementPool::Destroy" );
+            return false;
+        }
+
+        ConcurrentPoolSlot& slot = pSlots()[uiIndex];
+        uint32 uiGeneration = slot.uiGeneration.load( std::memory_order_acquire );
+        if( !( uiGeneration & 1 ) || MakeHandle( uiGeneration, uiIndex ) != uiHandle ||
+            !slot.uiGeneration.compare_exchange_strong( uiGeneration, uiGeneration + 1,
+                                                        std::memory_order_acq_rel ) )
+        {
+            BGASSERT( 0, "Double delete or stale handle passed in to ConcurrentElementPool." );
+            return false;
+        }
+
+        pElements()[uiIndex].~ELEMTYPE();
+        m_uiCount.fetch_sub( 1, std::memory_order_relaxed );
+        PushFree( uiIndex );
+        return true;
+    }
+
+    bool IsValid( uint32 uiHandle ) const
+    {
+        uint32 const uiIndex = uiHandle & ELEMENT_POOL_INDEX_MASK;
+        if( uiIndex >= m_uiCommittedCount.load( std::memory_order_acquire ) )
+        {
+            return false;
+        }
+        ConcurrentPoolSlot const& slot = pSlots()[uiIndex];
+        uint32 const uiGeneration = slot.uiGeneration.load( std::memory_order_acquire );
+        return ( uiGeneration & 1 ) && MakeHandle( uiGeneration, uiIndex ) == uiHandle;
+    }
+
+    ELEMTYPE* Get( uint32 uiHandle )
+    {
+        if( !IsValid( uiHandle ) )
+        {
+            BGASSERT( 0, "Bad pool access. Getting dead Handle." );
+            return nullptr;
+        }
+        return &pElements()[uiHandle & ELEMENT_POOL_INDEX_MASK];
+    }
+
+    ELEMTYPE* TryGet( uint32 uiHandle )
+    {
+        return IsValid( uiHandle ) ? &pElements()[uiHandle & ELEMENT_POOL_INDEX_MASK] : nullptr;
+    }
+
+    ELEMTYPE& operator[]( uint32 const uiHandle ) { return *Get( uiHandle ); }
+    uint32 const count() const { return m_uiCount.load( std::memory_order_relaxed ); }
+    uint32 const commit_count() const { return m_uiCommitCount.load( std::memory_order_relaxed ); }
+
+  private:
+    static constexpr uint64 FREE_INDEX_MASK = max_uint32;
+
+    static uint32 MakeHandle( uint32 uiGeneration, uint32 uiIndex )
+    {
+        return ( ( uiGeneration >> 1 ) << ELEMENT_POOL_INDEX_BITS ) | uiIndex;
+    }
+
+    ConcurrentPoolSlot* pSlots() const { return (ConcurrentPoolSlot*)m_pMem; }
+    ELEMTYPE* pElements() const { return (ELEMTYPE*)( m_pMem + m_uiElementsOffset ); }
+
+    uint32 PopFree()
+    {
+        uint64 uiHead = m_uiFreeHead.load( std::memory_order_acquire );
+        while( ( uiHead & FREE_INDEX_MASK ) != INVALID )
+        {
+            uint32 const uiIndex = (uint32)( uiHead & FREE_INDEX_MASK );
+            // NOTE(asr): May read a link another thread is rewriting, the tag then fails the CAS
+            uint32 const uiNext = pSlots()[uiIndex].uiNextFree.load( std::memory_order_relaxed );
+            uint64 const uiNewHead = ( ( ( uiHead >> 32 ) + 1 ) << 32 ) | uiNext;
+            if( m_uiFreeHead.compare_exchange_weak( uiHead, uiNewHead, std::memory_order_acquire,
+                                                    std::memory_order_acquire ) )
+            {
+                return uiIndex;
+            }
+        }
+        return INVALID;
+    }
+
+    void PushFree( uint32 uiIndex )
+    {
+        uint64 uiHead = m_uiFreeHead.load( std::memory_order_relaxed );
+        for( ;; )
+        {
+            pSlots()[uiIndex].uiNextFree.store( (uint32)( uiHead & FREE_INDEX_MASK ),
+                                                std::memory_order_relaxed );
+            uint64 const uiNewHead = ( ( ( uiHead >> 32 ) + 1 ) << 32 ) | uiIndex;
+            if( m_uiFreeHead.compare_exchange_weak( uiHead, uiNewHead, std::memory_order_release,
+                                                    std::memory_order_relaxed ) )
+            {
+                return;
+            }
+        }
+    }
+
+    // Same commit lock as ConcurrentArenaCommitTo, slots and elements grow together
+    void CommitTo( uint32 uiSlotCount )
+    {
+        while( m_uiCommittedCount.load( std::memory_order_acquire ) < uiSlotCount )
+        {
+            uint32 uiUnlocked = 0;
+            if( !m_uiCommitLock.compare_exchange_weak( uiUnlocked, 1, std::memory_order_acquire ) )
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            uint32 const uiCommitted = m_uiCommittedCount.load( std::memory_order_relaxed );
+            if( uiCommitted < uiSlotCount )
+            {
+                uint64 const uiPageSize = Memory::GetPageSize();
+                uint32 const uiGrowCount = MAX( uiSlotCount, uiCommitted + uiGrowthSize );
+                uint32 const uiNewCommitted = MIN( uiGrowCount, MAX_SLOTS );
+                CommitRange( uiCommitted * sizeof( ConcurrentPoolSlot ),
+                             uiNewCommitted * sizeof( ConcurrentPoolSlot ), uiPageSize );
+                CommitRange( m_uiElementsOffset + uiCommitted * sizeof( ELEMTYPE ),
+                             m_uiElementsOffset + uiNewCommitted * sizeof( ELEMTYPE ), uiPageSize );
+                m_uiCommitCount.fetch_add( 1, std::memory_order_relaxed );
+                m_uiCommittedCount.store( uiNewCommitted, std::memory_order_release );
+            }
+            m_uiCommitLock.store( 0, std::memory_order_release );
+        }
+    }
+
+    // Commits the pages of [uiBegin, uiEnd) not already covered by the page holding uiBegin - 1
+    void CommitRange( uint64 uiBegin, uint64 uiEnd, uint64 uiPageSize )
+    {
+        uint64 const uiCommitBegin = ALIGNUP_POW2( uiBegin, uiPageSize );
+        uint64 const uiCommitEnd = ALIGNUP_POW2( uiEnd, uiPageSize );
+        if( uiCommitEnd > uiCommitBegin )
+        {
+            Memory::Commit( m_pMem + uiCommitBegin, uiCommitEnd - uiCommitBegin );
+        }
+    }
+
+    uint8* m_pMem = nullptr;
+    uint64 m_uiElementsOffset = 0;
+    uint64 m_uiReservedSize = 0;
+    alignas( 64 ) std::atomic<uint64> m_uiFreeHead = INVALID; // Tag in the high half, index low
+    alignas( 64 ) std::atomic<uint32> m_uiSlotCount = 0;
+    std::atomic<uint32> m_uiCommittedCount = 0;
+    std::atomic<uint32> m_uiCommitLock = 0;
+    std::atomic<uint32> m_uiCommitCount = 0;
+    alignas( 64 ) std::atomic<uint32> m_uiCount = 0;
+};
+
+} // namespace Core
+} // namespace Bogus
+#endif
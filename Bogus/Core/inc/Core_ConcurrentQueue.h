@@ -0,0 +1,239 @@
+#ifndef CORE_CONCURRENTQUEUE_H
+#define CORE_CONCURRENTQUEUE_H
+#include "Core_Arena.h"
+#include "Core_Assert.h"
+#include "Globals.h"
+#include <atomic>
+#include <new>
+
+namespace Bogus
+{
+namespace Core
+{
+static constexpr uint64 CONCURRENT_QUEUE_CACHE_LINE_SIZE = 64;
+
+// ------------------------------------------------------
+// NOTE(asr): Slot storage for the queues below. Both hand out uiCapacity slots that the queue
+// constructs in place, the arena one reserving exactly what it needs from an arena of its own.
+template <typename tSlot, uint32 uiCapacity> struct ConcurrentQueuePolicyArena
+{
+    ConcurrentQueuePolicyArena()
+    {
+        uint64 const uiSize = ALIGNUP_POW2( uiCapacity * sizeof( tSlot ), Memory::GetPageSize() );
+        m_pArena = ArenaAlloc( { uiSize + ARENA_HEADER_SIZE + CONCURRENT_QUEUE_CACHE_LINE_SIZE,
+                                 uiSize + ARENA_HEADER_SIZE + CONCURRENT_QUEUE_CACHE_LINE_SIZE,
+                                 "ConcurrentQueueArena" } );
+        m_pSlots = ArenaPushArrayNoZeroAligned<tSlot>( m_pArena, uiCapacity,
+                                                       CONCURRENT_QUEUE_CACHE_LINE_SIZE );
+        BGASSERT( m_pSlots, "Failed to allocate concurrent queue slots." );
+    }
+    ConcurrentQueuePolicyArena( ConcurrentQueuePolicyArena const& ) = delete;
+    ConcurrentQueuePolicyArena& operator=( ConcurrentQueuePolicyArena const& ) = delete;
+    ~ConcurrentQueuePolicyArena() { ArenaRelease( m_pArena ); }
+
+    tSlot* pSlots() { return m_pSlots; }
+
+    tSlot* m_pSlots = nullptr;
+    Arena* m_pArena = nullptr;
+};
+
+template <typename tSlot, uint32 uiCapacity> struct ConcurrentQueuePolicyStatic
+{
+    tSlot* pSlots() { return reinterpret_cast<tSlot*>( m_Slots ); }
+
+    alignas( CONCURRENT_QUEUE_CACHE_LINE_SIZE ) uint8 m_Slots[uiCapacity * sizeof( tSlot )];
+};
+
+// ------------------------------------------------------
+// NOTE(asr): Wait free single producer single consumer ring. Each side owns one free running
+// index on its own cache line and keeps a copy of the other side's index, only reloading it when
+// the ring looks full (producer) or empty (consumer), so most operations touch no shared line.
+template <typename tElemType, uint32 uiCapacity,
+          template <typename, uint32> typename tStorage = ConcurrentQueuePolicyArena>
+struct SpscQueue : tStorage<tElemType, uiCapacity>
+{
+    using ELEMTYPE = tElemType;
+    static_assert( uiCapacity > 1 && ( uiCapacity & ( uiCapacity - 1 ) ) == 0,
+                   "Capacity must be a power of two" );
+    static_assert( uiCapacity <= ( 1u << 31 ), "Capacity must fit the index wrap" );
+    static constexpr uint32 MASK = uiCapacity - 1;
+
+    SpscQueue()
+    {
+        ELEMTYPE* pSlots = this->pSlots();
+        for( uint32 i = 0; i < uiCapacity; ++i )
+        {
+            new( &pSlots[i] ) ELEMTYPE();
+        }
+    }
+    SpscQueue( SpscQueue const& ) = delete;
+    SpscQueue& operator=( SpscQueue const& ) = delete;
+
+    // Producer only
+    bool try_push( ELEMTYPE const& in_Element )
+    {
+        uint32 const uiTail = m_uiTail.load( std::memory_order_relaxed );
+        if( uiTail - m_uiCachedHead == uiCapacity )
+        {
+            m_uiCachedHead = m_uiHead.load( std::memory_order_acquire );
+            if( uiTail - m_uiCachedHead == uiCapacity )
+            {
+                return false;
+            }
+        }
+
+        this->pSlots()[uiTail & MASK] = in_Element;
+        m_uiTail.store( uiTail + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Consumer only
+    bool try_pop( ELEMTYPE* pOutElement )
+    {
+        uint32 const uiHead = m_uiHead.load( std::memory_order_relaxed );
+        if( uiHead == m_uiCachedTail )
+        {
+            m_uiCachedTail = m_uiTail.load( std::memory_order_acquire );
+            if( uiHead == m_uiCachedTail )
+            {
+                return false;
+            }
+        }
+
+        *pOutElement = this->pSlots()[uiHead & MASK];
+        m_uiHead.store( uiHead + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Exact only when called from either side while the other is idle
+    uint32 count_approx() const
+    {
+        return m_uiTail.load( std::memory_order_acquire ) -
+               m_uiHead.load( std::memory_order_acquire );
+    }
+    uint32 const capacity() const { return uiCapacity; }
+
+    alignas( CONCURRENT_QUEUE_CACHE_LINE_SIZE ) std::atomic<uint32> m_uiHead = 0;
+    uint32 m_uiCachedTail = 0; // Consumer's copy of m_uiTail
+    alignas( CONCURRENT_QUEUE_CACHE_LINE_SIZE ) std::atomic<uint32> m_uiTail = 0;
+    uint32 m_uiCachedHead = 0; // Producer's copy of m_uiHead
+};
+
+// ------------------------------------------------------
+// NOTE(asr): Bounded multi producer multi consumer queue after Dmitry Vyukov's. Every slot carries
+// a sequence number telling whose turn it is: pos when free for the producer claiming pos, pos + 1
+// once filled for the consumer claiming pos. Claims are a single CAS on the shared index and a full
+// or empty queue fails the try instead of waiting.
+template <typename tElemType> struct MpmcQueueSlot
+{
+    std::atomic<uint64> uiSequence;
+    tElemType data;
+};
+
+template <typename tElemType, uint32 uiCapacity,
+          template <typename, uint32> typename tStorage = ConcurrentQueuePolicyArena>
+struct MpmcQueue : tStorage<MpmcQueueSlot<tElemType>, uiCapacity>
+{
+    using ELEMTYPE = tElemType;
+    using SLOT = MpmcQueueSlot<tElemType>;
+    static_assert( uiCapacity > 1 && ( uiCapacity & ( uiCapacity - 1 ) ) == 0,
+                   "Capacity must be a power of two" );
+    static constexpr uint64 MASK = uiCapacity - 1;
+
+    MpmcQueue()
+    {
+        SLOT* pSlots = this->pSlots();
+        for( uint32 i = 0; i < uiCapacity; ++i )
+        {
+            new( &pSlots[i] ) SLOT();
+            pSlots[i].uiSequence.store( i, std::memory_order_relaxed );
+        }
+    }
+    MpmcQueue( MpmcQueue const& ) = delete;
+    MpmcQueue& operator=( MpmcQueue const& ) = delete;
+
+    bool try_push( ELEMTYPE const& in_Element )
+    {
+        SLOT* pSlot = nullptr;
+        uint64 uiPos = m_uiEnqueuePos.load( std::memory_order_relaxed );
+        for( ;; )
+        {
+            pSlot = &this->pSlots()[uiPos & MASK];
+            uint64 const uiSequence = pSlot->uiSequence.load( std::memory_order_acquire );
+            int64 const iDiff = (int64)( uiSequence - uiPos );
+            if( iDiff == 0 )
+            {
+                if( m_uiEnqueuePos.compare_exchange_weak( uiPos, uiPos + 1,
+                                                          std::memory_order_relaxed ) )
+                {
+                    break;
+                }
+            }
+            else if( iDiff < 0 )
+            {
+                return false; // Full, the slot still holds the element from a lap ago
+            }
+            else
+            {
+                uiPos = m_uiEnqueuePos.load( std::memory_order_relaxed );
+            }
+        }
+
+        pSlot->data = in_Element;
+        pSlot->uiSequence.store( uiPos + 1, std::memory_order_release );
+        return true;
+    }
+
+    bool try_pop( ELEMTYPE* pOutElement )
+    {
+        SLOT* pSlot = nullptr;
+        uint64 uiPos = m_uiDequeuePos.load( std::memory_order_relaxed );
+        for( ;; )
+        {
+            pSlot = &this->pSlots()[uiPos & MASK];
+            uint64 const uiSequence = pSlot->uiSequence.load( std::memory_order_acquire );
+            int64 const iDiff = (int64)( uiSequence - ( uiPos + 1 ) );
+            if( iDiff == 0 )
+            {
+                if( m_uiDequeuePos.compare_exchange_weak( uiPos, uiPos + 1,
+                                                          std::memory_order_relaxed ) )
+                {
+                    break;
+                }
+            }
+            else if( iDiff < 0 )
+            {
+                return false; // Empty, the producer for this slot has not published yet
+            }
+            else
+            {
+                uiPos = m_uiDequeuePos.load( std::memory_order_relaxed );
+            }
+        }
+
+        *pOutElement = pSlot->data;
+        pSlot->uiSequence.store( uiPos + MASK + 1, std::memory_order_release );
+        return true;
+    }
+
+    uint32 count_approx() const
+    {
+        uint64 const uiEnqueuePos = m_uiEnqueuePos.load( std::memory_order_acquire );
+        uint64 const uiDequeuePos = m_uiDequeuePos.load( std::memory_order_acquire );
+        return uiEnqueuePos > uiDequeuePos ? (uint32)( uiEnqueuePos - uiDequeuePos ) : 0;
+    }
+    uint32 const capacity() const { return uiCapacity; }
+
+    alignas( CONCURRENT_QUEUE_CACHE_LINE_SIZE ) std::atomic<uint64> m_uiEnqueuePos = 0;
+    alignas( CONCURRENT_QUEUE_CACHE_LINE_SIZE ) std::atomic<uint64> m_uiDequeuePos = 0;
+};
+
+template <typename tElemType, uint32 uiCapacity>
+using StaticSpscQueue = SpscQueue<tElemType, uiCapacity, ConcurrentQueuePolicyStatic>;
+
+template <typename tElemType, uint32 uiCapacity>
+using StaticMpmcQueue = MpmcQueue<tElemType, uiCapacity, ConcurrentQueuePolicyStatic>;
+
+} // namespace Core
+} // namespace Bogus
+#endif
@@ -0,0 +1,60 @@
+#ifndef CORE_DOUBLEENDEDARENA_H
+#define CORE_DOUBLEENDEDARENA_H
+#include "Core_Arena.h"
+#include "Globals.h"
+#include <cstring>
+
+namespace Bogus
+{
+namespace Core
+{
+
+// ------------------------------------------------------
+// NOTE(asr): Two stacks sharing one reservation. The bottom grows up from the header and the top
+// grows down from the end of the reservation, each committing pages towards the other. Both
+// sides hand out positions as markers to pop back to, independently of each other. Typical use
+// is long lived results on the bottom and load time temporaries on the top.
+struct alignas( 128 ) DoubleEndedArena
+{
+    ArenaAllocParams initParams;
+    uint64 uiBottomPos = 0;
+    uint64 uiTopPos = 0; // Offset of the lowest byte in use by the top stack
+    uint64 uiBottomCommitPos = 0; // [0, uiBottomCommitPos) is committed
+    uint64 uiTopCommitPos = 0;    // [uiTopCommitPos, uiReservedSize) is committed
+    uint64 uiReservedSize = 0;
+    uint32 uiCommitCount = 0;
+};
+static constexpr uint32 DOUBLE_ENDED_ARENA_HEADER_SIZE = sizeof( DoubleEndedArena );
+
+DoubleEndedArena* DoubleEndedArenaAlloc( ArenaAllocParams const& params );
+void DoubleEndedArenaRelease( DoubleEndedArena* pArena );
+
+uint64 DoubleEndedArenaGetBottomPos( DoubleEndedArena* pArena );
+uint64 DoubleEndedArenaGetTopPos( DoubleEndedArena* pArena );
+uint64 DoubleEndedArenaGetFreeSize( DoubleEndedArena* pArena );
+
+uint8* DoubleEndedArenaPushBottom( DoubleEndedArena* pArena, uint64 uiSize, uint64 uiAlignment );
+uint8* DoubleEndedArenaPushTop( DoubleEndedArena* pArena, uint64 uiSize, uint64 uiAlignment );
+
+void DoubleEndedArenaPopBottomTo( DoubleEndedArena* pArena, uint64 uiPos );
+void DoubleEndedArenaPopTopTo( DoubleEndedArena* pArena, uint64 uiPos );
+void DoubleEndedArenaClearTop( DoubleEndedArena* pArena );
+void DoubleEndedArenaClear( DoubleEndedArena* pArena );
+
+template <typename T> T* DoubleEndedArenaPushBottomArray( DoubleEndedArena* pArena, uint32 uiCount )
+{
+    uint64 const uiTotalSize = sizeof( T ) * uiCount;
+    void* pData = DoubleEndedArenaPushBottom( pArena, uiTotalSize, MAX( 8, ALIGNOF( T ) ) );
+    return reinterpret_cast<T*>( pData ? memset( pData, 0, uiTotalSize ) : nullptr );
+}
+
+template <typename T> T* DoubleEndedArenaPushTopArray( DoubleEndedArena* pArena, uint32 uiCount )
+{
+    uint64 const uiTotalSize = sizeof( T ) * uiCount;
+    void* pData = DoubleEndedArenaPushTop( pArena, uiTotalSize, MAX( 8, ALIGNOF( T ) ) );
+    return reinterpret_cast<T*>( pData ? memset( pData, 0, uiTotalSize ) : nullptr );
+}
+
+} // namespace Core
+} // namespace Bogus
+#endif
@@ -0,0 +1,160 @@
+#ifndef CORE_FLATMAP_H
+#define CORE_FLATMAP_H
+#include "Core_Arena.h"
+#include "Core_Assert.h"
+#include "Core_Vector.h"
+#include "Globals.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined( _MSC_VER )
+#include <xmmintrin.h>
+#define FLATMAP_PREFETCH( pAddr ) _mm_prefetch( (char const*)( pAddr ), _MM_HINT_T0 )
+#else
+#define FLATMAP_PREFETCH( pAddr ) __builtin_prefetch( pAddr )
+#endif
+
+namespace Bogus
+{
+namespace Core
+{
+
+// -----------------------------------------------------------------------
+// -----------------------------------------------------------------------
+// NOTE(asr): Read mostly map over a Vector of VectorMapPair. Pairs are added unsorted, then build()
+// sorts them once and lays them out in Eytzinger order: an implicit binary tree stored breadth
+// first, node k (1 based) having children 2k and 2k + 1. Lookups descend it without branching on
+// the comparison and prefetch the 16 contiguous descendants 4 levels down. Iteration walks the
+// tree in order so it still visits keys sorted. Duplicate keys keep the first added.
+template <typename tPairVector> struct SortedFlatMap
+{
+    using VEC = tPairVector;
+    using PAIR = typename VEC::ELEMTYPE;
+    using KEY = typename VEC::ELEMTYPE::KEY;
+    using ELEMTYPE = typename VEC::ELEMTYPE::ELEMENT;
+
+    struct iterator
+    {
+        PAIR& operator*() const { return pMap->m_Vec.pData()[uiNode - 1]; }
+        PAIR* operator->() const { return &pMap->m_Vec.pData()[uiNode - 1]; }
+        bool operator!=( iterator const& other ) const { return uiNode != other.uiNode; }
+        bool operator==( iterator const& other ) const { return uiNode == other.uiNode; }
+        iterator& operator++()
+        {
+            uiNode = NextNode( uiNode, pMap->m_Vec.size() );
+            return *this;
+        }
+
+        SortedFlatMap* pMap;
+        uint64 uiNode; // 1 based, 0 is the end
+    };
+
+    uint32 size() const { return m_Vec.size(); }
+    bool built() const { return m_bBuilt; }
+
+    // Staged until the next build()
+    void add( KEY const& key, ELEMTYPE const& element )
+    {
+        m_Vec.push( PAIR( key, element ) );
+        m_bBuilt = false;
+    }
+
+    void build()
+    {
+        uint32 uiCount = m_Vec.size();
+        PAIR* pData = m_Vec.pData();
+        std::stable_sort( pData, pData + uiCount,
+                          []( PAIR const& a, PAIR const& b ) { return a.m_Key < b.m_Key; } );
+        PAIR* pLast = std::unique( pData, pData + uiCount, []( PAIR const& a, PAIR const& b )
+                                   { return !( a.m_Key < b.m_Key ) && !( b.m_Key < a.m_Key ); } );
+        uint32 const uiUniqueCount = (uint32)( pLast - pData );
+        if( uiUniqueCount < uiCount )
+        {
+            m_Vec.pop_to( uiUniqueCount );
+            uiCount = uiUniqueCount;
+        }
+
+        if( uiCount )
+        {
+            ArenaTemp scratch = GetScratch();
+            PAIR* pSorted = ArenaPushArrayNoZero<PAIR>( scratch.pArena, uiCount );
+            memcpy( (void*)pSorted, pData, sizeof( PAIR ) * uiCount );
+
+            uint64 uiNode = FirstNode( uiCount );
+            for( uint32 i = 0; i < uiCount; ++i )
+            {
+                memcpy( (void*)&pData[uiNode - 1], &pSorted[i], sizeof( PAIR ) );
+                uiNode = NextNode( uiNode, uiCount );
+            }
+        }
+        m_bBuilt = true;
+    }
+
+    // First pair whose key is not less than key
+    iterator lower_bound( KEY const& key )
+    {
+        BGASSERT( m_bBuilt, "SortedFlatMap searched before build()." );
+        PAIR const* pData = m_Vec.pData();
+        uint64 const uiCount = m_Vec.size();
+        uint64 uiNode = 1;
+        while( uiNode <= uiCount )
+        {
+            FLATMAP_PREFETCH( pData + 16 * uiNode - 1 );
+            uiNode = 2 * uiNode + ( pData[uiNode - 1].m_Key < key );
+        }
+        // NOTE(asr): Undo the right turns taken after the last left one, that node is the answer
+        uiNode >>= std::countr_one( uiNode ) + 1;
+        return { this, uiNode };
+    }
+
+    ELEMTYPE* find( KEY const& key )
+    {
+        iterator const it = lower_bound( key );
+        if( it.uiNode == 0 || key < it->m_Key )
+        {
+            return nullptr;
+        }
+        return &it->m_Element;
+    }
+
+    void clear()
+    {
+        if( m_Vec.size() )
+        {
+            m_Vec.pop_to( 0 );
+        }
+        m_bBuilt = true;
+    }
+
+    iterator begin() { return { this, m_Vec.size() ? FirstNode( m_Vec.size() ) : 0 }; }
+    iterator end() { return { this, 0 }; }
+
+  private:
+    static uint64 FirstNode( uint64 uiCount )
+    {
+        return std::bit_floor( uiCount );
+    }
+
+    // In order successor in the implicit tree, 0 past the last node
+    static uint64 NextNode( uint64 uiNode, uint64 uiCount )
+    {
+        if( 2 * uiNode + 1 <= uiCount )
+        {
+            uiNode = 2 * uiNode + 1;
+            while( 2 * uiNode <= uiCount )
+            {
+                uiNode *= 2;
+            }
+            return uiNode;
+        }
+        return uiNode >> ( std::countr_one( uiNode ) + 1 );
+    }
+
+    VEC m_Vec;
+    bool m_bBuilt = true;
+};
+
+} // namespace Core
+} // namespace Bogus
+#endif
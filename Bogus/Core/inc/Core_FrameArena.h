@@ -0,0 +1,37 @@
+#ifndef CORE_FRAMEARENA_H
+#define CORE_FRAMEARENA_H
+#include "Core_Arena.h"
+#include "Globals.h"
+
+namespace Bogus
+{
+namespace Core
+{
+static constexpr uint32 FRAME_ARENA_MAX_FRAMES = 8;
+
+// ------------------------------------------------------
+// NOTE(asr): One arena per frame in flight. A frame's arena is cleared in bulk when that frame
+// slot comes around again, which is only legal once the fence signalled at the end of the
+// frame that last used it has completed. Memory pushed during a frame lives until then.
+struct FrameArenaRing
+{
+    Arena* pArenas[FRAME_ARENA_MAX_FRAMES] = {};
+    uint64 uiFenceValues[FRAME_ARENA_MAX_FRAMES] = {};
+    uint32 uiFrameCount = 0;
+    uint32 uiCurrentFrame = 0;
+};
+
+void FrameArenaRingInit( FrameArenaRing* pRing, uint32 uiFrameCount,
+                         ArenaAllocParams const& params );
+void FrameArenaRingRelease( FrameArenaRing* pRing );
+
+// uiCompletedFenceValue is the last fence value the GPU is known to have reached
+Arena* FrameArenaRingBeginFrame( FrameArenaRing* pRing, uint32 uiFrameIndex,
+                                 uint64 uiCompletedFenceValue );
+// uiFenceValue is signalled once the GPU is done with everything recorded this frame
+void FrameArenaRingEndFrame( FrameArenaRing* pRing, uint64 uiFenceValue );
+Arena* FrameArenaRingGetCurrent( FrameArenaRing* pRing );
+
+} // namespace Core
+} // namespace Bogus
+#endif
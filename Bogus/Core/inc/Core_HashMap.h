@@ -0,0 +1,400 @@
+#ifndef CORE_HASHMAP_H
+#define CORE_HASHMAP_H
+#include "Core_Arena.h"
+#include "Core_Assert.h"
+#include "Core_String.h"
+#include "Core_Utility.h"
+#include "Core_Vector.h"
+#include "Globals.h"
+#include <bit>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define HASHMAP_USE_SSE2 1
+#include <emmintrin.h>
+#elif defined( __ARM_NEON ) || defined( _M_ARM64 )
+#define HASHMAP_USE_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Bogus
+{
+namespace Core
+{
+static constexpr uint32 HASHMAP_GROUP_WIDTH = 16;
+static constexpr uint64 HASHMAP_MIN_CAPACITY = HASHMAP_GROUP_WIDTH;
+static constexpr int8 HASHMAP_CTRL_EMPTY = -128; // 0b10000000
+static constexpr int8 HASHMAP_CTRL_DELETED = -2; // 0b11111110, full slots hold 7 hash bits
+
+// ------------------------------------------------------
+// Default hasher. Integers get a 64 bit finalizer, anything else is hashed bytewise so it must
+// have no padding.
+template <typename tKey> struct HashMapHasher
+{
+    static uint64 Hash( tKey const& key )
+    {
+        if constexpr( std::is_integral_v<tKey> || std::is_enum_v<tKey> )
+        {
+            uint64 uiHash = (uint64)key;
+            uiHash ^= uiHash >> 33;
+            uiHash *= 0xff51afd7ed558ccdull;
+            uiHash ^= uiHash >> 33;
+            uiHash *= 0xc4ceb9fe1a85ec53ull;
+            uiHash ^= uiHash >> 33;
+            return uiHash;
+        }
+        else
+        {
+            return Hash32( &key, sizeof( tKey ) );
+        }
+    }
+    static bool Equal( tKey const& a, tKey const& b ) { return a == b; }
+};
+
+// NOTE(asr): Reuses the hash computed when the token was made. The map stores the token, not the
+// string, so the characters must outlive the map.
+template <> struct HashMapHasher<String::HashToken>
+{
+    static uint64 Hash( String::HashToken const& key ) { return key.m_uiHash; }
+    static bool Equal( String::HashToken const& a, String::HashToken const& b )
+    {
+        return a.m_uiHash == b.m_uiHash && a.m_uiLen == b.m_uiLen &&
+               memcmp( a.m_pData, b.m_pData, a.m_uiLen ) == 0;
+    }
+};
+
+// ------------------------------------------------------
+// NOTE(asr): 16 control bytes compared at once. Masks hold one set bit per matching slot,
+// MASK_SHIFT converts a bit index to a slot index.
+struct HashMapGroup
+{
+#if defined( HASHMAP_USE_SSE2 )
+    static constexpr uint32 MASK_SHIFT = 0;
+    explicit HashMapGroup( int8 const* pCtrl ) : ctrl( _mm_loadu_si128( (__m128i const*)pCtrl ) )
+    {
+    }
+    uint64 Match( int8 iH2 ) const
+    {
+        return (uint32)_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_set1_epi8( iH2 ), ctrl ) );
+    }
+    uint64 MatchEmptyOrDeleted() const { return (uint32)_mm_movemask_epi8( ctrl ); }
+
+    __m128i ctrl;
+#elif defined( HASHMAP_USE_NEON )
+    static constexpr uint32 MASK_SHIFT = 2;
+    explicit HashMapGroup( int8 const* pCtrl ) : ctrl( vld1q_s8( pCtrl ) ) {}
+    static uint64 ToMask( uint8x16_t cmp )
+    {
+        // Narrow every byte to a nibble, then keep one bit per nibble
+        uint8x8_t const narrowed = vshrn_n_u16( vreinterpretq_u16_u8( cmp ), 4 );
+        return vget_lane_u64( vreinterpret_u64_u8( narrowed ), 0 ) & 0x8888888888888888ull;
+    }
+    uint64 Match( int8 iH2 ) const { return ToMask( vceqq_s8( ctrl, vdupq_n_s8( iH2 ) ) ); }
+    uint64 MatchEmptyOrDeleted() const { return ToMask( vcltq_s8( ctrl, vdupq_n_s8( 0 ) ) ); }
+
+    int8x16_t ctrl;
+#else
+    static constexpr uint32 MASK_SHIFT = 0;
+    explicit HashMapGroup( int8 const* pCtrl ) { memcpy( ctrl, pCtrl, HASHMAP_GROUP_WIDTH ); }
+    uint64 Match( int8 iH2 ) const
+    {
+        uint64 uiMask = 0;
+        for( uint32 i = 0; i < HASHMAP_GROUP_WIDTH; ++i )
+        {
+            uiMask |= (uint64)( ctrl[i] == iH2 ) << i;
+        }
+        return uiMask;
+    }
+    uint64 MatchEmptyOrDeleted() const
+    {
+        uint64 uiMask = 0;
+        for( uint32 i = 0; i < HASHMAP_GROUP_WIDTH; ++i )
+        {
+            uiMask |= (uint64)( ctrl[i] < 0 ) << i;
+        }
+        return uiMask;
+    }
+
+    int8 ctrl[HASHMAP_GROUP_WIDTH];
+#endif
+    uint64 MatchEmpty() const { return Match( HASHMAP_CTRL_EMPTY ); }
+    static uint32 MaskIndex( uint64 uiMask ) { return std::countr_zero( uiMask ) >> MASK_SHIFT; }
+};
+
+// -----------------------------------------------------------------------
+// -----------------------------------------------------------------------
+// NOTE(asr): Swiss table. One control byte per slot, empty/deleted or the low 7 bits of the
+// hash, probed a group at a time with SIMD so most misses never touch a slot. The first
+// HASHMAP_GROUP_WIDTH control bytes are mirrored past the end so groups can wrap. Storage is a
+// single block in the map's own arena, created on first insert; growing builds the new block
+// above the old one and moves it down. Pairs are relocated with memcpy.
+template <typename tKey, typename tElement, typename tHasher = HashMapHasher<tKey>> struct HashMap
+{
+    using KEY = tKey;
+    using ELEMTYPE = tElement;
+    using PAIR = VectorMapPair<tKey, tElement>;
+
+    struct iterator
+    {
+        PAIR& operator*() const { return *pSlot; }
+        PAIR* operator->() const { return pSlot; }
+        bool operator!=( iterator const& other ) const { return pSlot != other.pSlot; }
+        iterator& operator++()
+        {
+            ++pSlot;
+            ++pCtrl;
+            SkipEmpty();
+            return *this;
+        }
+        void SkipEmpty()
+        {
+            while( pCtrl < pCtrlEnd && *pCtrl < 0 )
+            {
+                ++pSlot;
+                ++pCtrl;
+            }
+        }
+
+        PAIR* pSlot;
+        int8 const* pCtrl;
+        int8 const* pCtrlEnd;
+    };
+
+    explicit HashMap( uint64 uiReserveSize = ARENA_DEFAULT_RESERVE_SIZE )
+        : m_uiReserveSize( uiReserveSize )
+    {
+    }
+    HashMap( HashMap const& ) = delete;
+    HashMap& operator=( HashMap const& ) = delete;
+    ~HashMap()
+    {
+        if( m_pArena )
+        {
+            ArenaRelease( m_pArena );
+        }
+    }
+
+    uint32 size() const { return m_uiSize; }
+    uint64 capacity() const { return m_uiCapacity; }
+
+    iterator begin()
+    {
+        iterator it = { m_pSlots, m_pCtrl, m_pCtrl + m_uiCapacity };
+        it.SkipEmpty();
+        return it;
+    }
+    iterator end() { return { m_pSlots + m_uiCapacity, nullptr, nullptr }; }
+
+    ELEMTYPE* find( KEY const& key )
+    {
+        uint64 const uiIndex = FindIndex( key, tHasher::Hash( key ) );
+        return uiIndex == max_uint64 ? nullptr : &m_pSlots[uiIndex].m_Element;
+    }
+    ELEMTYPE const* find( KEY const& key ) const
+    {
+        return const_cast<HashMap*>( this )->find( key );
+    }
+    bool contains( KEY const& key ) const { return find( key ) != nullptr; }
+
+    // Returns the existing element when the key is already present, like VectorMap::add
+    ELEMTYPE* add( KEY const& key, ELEMTYPE const& element, uint32* pExists = 0 )
+    {
+        uint64 const uiHash = tHasher::Hash( key );
+        uint64 uiIndex = FindIndex( key, uiHash );
+        if( uiIndex != max_uint64 )
+        {
+            if( pExists )
+                *pExists = 1;
+            return &m_pSlots[uiIndex].m_Element;
+        }
+
+        uiIndex = FindInsertIndex( uiHash );
+        if( uiIndex == max_uint64 )
+        {
+            return nullptr;
+        }
+        if( m_uiGrowthLeft == 0 && m_pCtrl[uiIndex] == HASHMAP_CTRL_EMPTY )
+        {
+            // NOTE(asr): Rehash in place when tombstones, not live entries, filled the table
+            bool const bMostlyDeleted = m_uiSize < m_uiCapacity * 7 / 16;
+            Rehash( bMostlyDeleted ? m_uiCapacity : m_uiCapacity * 2 );
+            if( m_uiGrowthLeft == 0 )
+            {
+                return nullptr;
+            }
+            uiIndex = FindInsertIndex( uiHash );
+        }
+
+        m_uiGrowthLeft -= m_pCtrl[uiIndex] == HASHMAP_CTRL_EMPTY;
+        SetCtrl( uiIndex, (int8)( uiHash & 0x7f ) );
+        new( &m_pSlots[uiIndex] ) PAIR( key, element );
+        ++m_uiSize;
+        return &m_pSlots[uiIndex].m_Element;
+    }
+
+    bool remove( KEY const& key )
+    {
+        uint64 const uiIndex = FindIndex( key, tHasher::Hash( key ) );
+        if( uiIndex == max_uint64 )
+        {
+            return false;
+        }
+        SetCtrl( uiIndex, HASHMAP_CTRL_DELETED );
+        --m_uiSize;
+        return true;
+    }
+
+    void clear()
+    {
+        if( m_uiCapacity )
+        {
+            memset( m_pCtrl, (uint8)HASHMAP_CTRL_EMPTY, m_uiCapacity + HASHMAP_GROUP_WIDTH );
+        }
+        m_uiSize = 0;
+        m_uiGrowthLeft = m_uiCapacity * 7 / 8;
+    }
+
+    void reserve( uint32 uiCount )
+    {
+        uint64 const uiMinCapacity = std::bit_ceil( (uint64)uiCount * 8 / 7 + 1 );
+        uint64 const uiCapacity = MAX( uiMinCapacity, HASHMAP_MIN_CAPACITY );
+        if( uiCapacity > m_uiCapacity )
+        {
+            Rehash( uiCapacity );
+        }
+    }
+
+  private:
+    static uint64 CtrlSize( uint64 uiCapacity )
+    {
+        return ALIGNUP_POW2( uiCapacity + HASHMAP_GROUP_WIDTH, ALIGNOF( PAIR ) );
+    }
+
+    void SetCtrl( uint64 uiIndex, int8 iCtrl )
+    {
+        m_pCtrl[uiIndex] = iCtrl;
+        if( uiIndex < HASHMAP_GROUP_WIDTH )
+        {
+            m_pCtrl[m_uiCapacity + uiIndex] = iCtrl;
+        }
+    }
+
+    uint64 FindIndex( KEY const& key, uint64 uiHash ) const
+    {
+        if( !m_uiCapacity )
+        {
+            return max_uint64;
+        }
+
+        uint64 const uiMask = m_uiCapacity - 1;
+        int8 const iH2 = (int8)( uiHash & 0x7f );
+        uint64 uiPos = ( uiHash >> 7 ) & uiMask;
+        for( uint64 uiStep = HASHMAP_GROUP_WIDTH;; uiStep += HASHMAP_GROUP_WIDTH )
+        {
+            HashMapGroup const group( m_pCtrl + uiPos );
+            for( uint64 uiMatch = group.Match( iH2 ); uiMatch; uiMatch &= uiMatch - 1 )
+            {
+                uint64 const uiIndex = ( uiPos + HashMapGroup::MaskIndex( uiMatch ) ) & uiMask;
+                if( tHasher::Equal( m_pSlots[uiIndex].m_Key, key ) )
+                {
+                    return uiIndex;
+                }
+            }
+            if( group.MatchEmpty() )
+            {
+                return max_uint64;
+            }
+            uiPos = ( uiPos + uiStep ) & uiMask;
+        }
+    }
+
+    uint64 FindInsertIndex( uint64 uiHash )
+    {
+        if( !m_uiCapacity )
+        {
+            Rehash( HASHMAP_MIN_CAPACITY );
+            if( !m_uiCapacity )
+            {
+                return max_uint64;
+            }
+        }
+
+        uint64 const uiMask = m_uiCapacity - 1;
+        uint64 uiPos = ( uiHash >> 7 ) & uiMask;
+        for( uint64 uiStep = HASHMAP_GROUP_WIDTH;; uiStep += HASHMAP_GROUP_WIDTH )
+        {
+            uint64 const uiFree = HashMapGroup( m_pCtrl + uiPos ).MatchEmptyOrDeleted();
+            if( uiFree )
+            {
+                return ( uiPos + HashMapGroup::MaskIndex( uiFree ) ) & uiMask;
+            }
+            uiPos = ( uiPos + uiStep ) & uiMask;
+        }
+    }
+
+    void Rehash( uint64 uiNewCapacity )
+    {
+        if( !m_pArena )
+        {
+            m_pArena = ArenaAlloc( { .uiReserveSize = m_uiReserveSize, .name = "HashMap" } );
+        }
+
+        uint64 const uiBlockSize = CtrlSize( uiNewCapacity ) + uiNewCapacity * sizeof( PAIR );
+        uint8* pBlock = ArenaPush( m_pArena, uiBlockSize, 64 );
+        if( !pBlock )
+        {
+            BGASSERT( 0, "HashMap ran out of memory. Pass a bigger reserve size." );
+            return;
+        }
+        uint64 const uiBlockPos = ArenaGetPos( m_pArena ) - uiBlockSize;
+
+        int8* pOldCtrl = m_pCtrl;
+        PAIR* pOldSlots = m_pSlots;
+        uint64 const uiOldCapacity = m_uiCapacity;
+
+        m_pCtrl = (int8*)pBlock;
+        m_pSlots = (PAIR*)( pBlock + CtrlSize( uiNewCapacity ) );
+        m_uiCapacity = uiNewCapacity;
+        m_uiGrowthLeft = uiNewCapacity * 7 / 8 - m_uiSize;
+        memset( m_pCtrl, (uint8)HASHMAP_CTRL_EMPTY, uiNewCapacity + HASHMAP_GROUP_WIDTH );
+
+        for( uint64 i = 0; i < uiOldCapacity; ++i )
+        {
+            if( pOldCtrl[i] >= 0 )
+            {
+                uint64 const uiHash = tHasher::Hash( pOldSlots[i].m_Key );
+                uint64 const uiIndex = FindInsertIndex( uiHash );
+                SetCtrl( uiIndex, (int8)( uiHash & 0x7f ) );
+                memcpy( (void*)&m_pSlots[uiIndex], &pOldSlots[i], sizeof( PAIR ) );
+            }
+        }
+
+        if( pOldCtrl )
+        {
+            // NOTE(asr): Slide the new block over the old one so the arena only ever holds one
+            memmove( (void*)pOldCtrl, pBlock, uiBlockSize );
+            ArenaPopTo( m_pArena, m_uiBlockPos + uiBlockSize );
+            m_pCtrl = pOldCtrl;
+            m_pSlots = (PAIR*)( (uint8*)pOldCtrl + CtrlSize( uiNewCapacity ) );
+        }
+        else
+        {
+            m_uiBlockPos = uiBlockPos;
+        }
+    }
+
+    Arena* m_pArena = nullptr;
+    int8* m_pCtrl = nullptr;
+    PAIR* m_pSlots = nullptr;
+    uint64 m_uiCapacity = 0;
+    uint64 m_uiGrowthLeft = 0;
+    uint64 m_uiBlockPos = 0;
+    uint64 m_uiReserveSize = ARENA_DEFAULT_RESERVE_SIZE;
+    uint32 m_uiSize = 0;
+};
+
+} // namespace Core
+} // namespace Bogus
+#endif
@@ -4,11 +4,45 @@
 
 namespace Bogus::Core::Memory
 {
+enum : uint32
+{
+    eMemFlag_None = 0,
+    eMemFlag_LargePages = 1 << 0, // Transparent huge pages (hint, falls back to regular pages)
+    eMemFlag_HugeTLB = 1 << 1,    // Explicit huge pages (falls back to eMemFlag_LargePages)
+    eMemFlag_Prefault = 1 << 2,   // Fault in pages at commit time instead of on first touch
+
+    // NOTE(asr): POSIX only. The range is mapped read/write up front and backed on first touch,
+    // Commit/Decommit only manage the backing. Keeps a range split into many small commits as a
+    // single kernel mapping, which is otherwise capped by vm.max_map_count. Pass it to all three.
+    eMemFlag_CommitOnTouch = 1 << 3,
+};
+
+// NOTE(asr): Pass a node index to prefer that node, or one of these
+static constexpr int32 NUMA_NODE_ANY = -1;
+static constexpr int32 NUMA_NODE_INTERLEAVE = -2; // Spread pages round robin over all nodes
+static constexpr uint32 NUMA_MAX_NODES = 64;
+
+// NOTE(asr): Reserve/Release round sizes up to this, except HugeTLB reservations which are only
+// rounded to large pages so they don't pin more of the hugetlbfs pool than they can use.
+// GetReservedSize tells what a reservation really maps.
+static constexpr uint64 RESERVE_GRANULARITY = GIGABYTES( 1 );
+
 uint64 GetPageSize();
-void* Reserve( uint64 uiSize );
-void Release( void* pMem, uint64 uiSize );
-void Commit( void* pMem, uint64 uiSize );
-void Decommit( void* pMem, uint64 uiSize );
+uint64 GetLargePageSize();
+uint32 GetNumaNodeCount();
+uint32 GetCurrentNumaNode();
+uint64 GetReservedSize( uint64 uiSize, uint32 uiFlags = eMemFlag_None );
+void* Reserve( uint64 uiSize, uint32 uiFlags = eMemFlag_None, int32 iNumaNode = NUMA_NODE_ANY );
+// Pass the size and flags the range was reserved with
+void Release( void* pMem, uint64 uiSize, uint32 uiFlags = eMemFlag_None );
+void Commit( void* pMem, uint64 uiSize, uint32 uiFlags = eMemFlag_None );
+void Decommit( void* pMem, uint64 uiSize, uint32 uiFlags = eMemFlag_None );
+
+// NOTE(asr): Shared read/write view of a file, created or grown to uiSize. Writes go back to the
+// file when the view is flushed or unmapped. pOutFileSize receives the size before growing.
+void* MapFile( char const* szPath, uint64 uiSize, uint64* pOutFileSize = nullptr );
+void UnmapFile( void* pMem, uint64 uiSize );
+void FlushFile( void* pMem, uint64 uiSize );
 void Abort();
 } // namespace Bogus::Core::Memory
 
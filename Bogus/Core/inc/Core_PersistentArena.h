@@ -0,0 +1,169 @@
+#ifndef CORE_PERSISTENTARENA_H
+#define CORE_PERSISTENTARENA_H
+#include "Core_Assert.h"
+#include "Core_Vector.h"
+#include "Globals.h"
+#include <cstring>
+
+namespace Bogus
+{
+namespace Core
+{
+static constexpr uint64 PERSISTENT_ARENA_DEFAULT_CAPACITY = MEGABYTES( 64 );
+static constexpr uint32 PERSISTENT_ARENA_MAGIC = 0x41504742; // "BGPA"
+
+// ------------------------------------------------------
+// NOTE(asr): Pointer stored as the distance from itself to the target, so it stays valid wherever
+// the memory holding both ends gets mapped. Copies re-encode against their own address.
+template <typename T> struct OffsetPtr
+{
+    OffsetPtr() = default;
+    OffsetPtr( T* pTarget ) { set( pTarget ); }
+    OffsetPtr( OffsetPtr const& other ) { set( other.get() ); }
+    OffsetPtr& operator=( OffsetPtr const& other )
+    {
+        set( other.get() );
+        return *this;
+    }
+    OffsetPtr& operator=( T* pTarget )
+    {
+        set( pTarget );
+        return *this;
+    }
+
+    T* get() const { return m_iOffset ? (T*)( (uint8*)this + m_iOffset ) : nullptr; }
+    void set( T* pTarget ) { m_iOffset = pTarget ? (uint8*)pTarget - (uint8*)this : 0; }
+
+    T* operator->() const { return get(); }
+    T& operator*() const { return *get(); }
+    T& operator[]( uint64 uiIndex ) const { return get()[uiIndex]; }
+    explicit operator bool() const { return m_iOffset != 0; }
+
+    int64 m_iOffset = 0; // 0 is null, nothing points at itself
+};
+
+// ------------------------------------------------------
+struct PersistentArenaParams
+{
+    char const* szPath = nullptr;
+    uint64 uiCapacity = PERSISTENT_ARENA_DEFAULT_CAPACITY;
+    uint32 uiVersion = 0; // Bump when the layout of stored data changes to discard old files
+};
+
+// ------------------------------------------------------
+// NOTE(asr): Bump arena backed by a shared file mapping, with this header at the start of the
+// file. Everything pushed must be position independent, use OffsetPtr instead of raw pointers.
+// The checksum covers the header fields and the pushed data. It is only written by Save, so a
+// process dying between Open and Save leaves a file that fails validation next launch.
+struct alignas( 128 ) PersistentArena
+{
+    uint32 uiMagic = PERSISTENT_ARENA_MAGIC;
+    uint32 uiVersion = 0;
+    uint32 uiChecksum = 0;
+    uint32 uiHeaderSize = 0; // Catches header layout changes
+    uint64 uiPos = 0;
+    uint64 uiRootPos = 0; // 0 when no root was set
+    uint64 uiCapacity = 0;
+};
+static constexpr uint32 PERSISTENT_ARENA_HEADER_SIZE = sizeof( PersistentArena );
+
+// pOutLoaded is set when the file held valid data, otherwise the arena is empty and the caller
+// should rebuild and Save
+PersistentArena* PersistentArenaOpen( PersistentArenaParams const& params, bool* pOutLoaded );
+void PersistentArenaClose( PersistentArena* pArena );
+void PersistentArenaSave( PersistentArena* pArena );
+uint32 PersistentArenaCalcChecksum( PersistentArena* pArena );
+
+uint8* PersistentArenaPush( PersistentArena* pArena, uint64 uiSize, uint64 uiAlignment );
+void PersistentArenaClear( PersistentArena* pArena );
+
+// Entry point to find the stored data again after the file is mapped at another address
+void PersistentArenaSetRoot( PersistentArena* pArena, void* pRoot );
+void* PersistentArenaGetRoot( PersistentArena* pArena );
+
+template <typename T> T* PersistentArenaGetRoot( PersistentArena* pArena )
+{
+    return reinterpret_cast<T*>( PersistentArenaGetRoot( pArena ) );
+}
+
+template <typename T> T* PersistentArenaPushArrayNoZero( PersistentArena* pArena, uint32 uiCount )
+{
+    return reinterpret_cast<T*>(
+        PersistentArenaPush( pArena, sizeof( T ) * uiCount, MAX( 8, ALIGNOF( T ) ) ) );
+}
+
+// Memory reused after a failed validation holds stale file contents, this clears it
+template <typename T> T* PersistentArenaPushArray( PersistentArena* pArena, uint32 uiCount )
+{
+    T* pData = PersistentArenaPushArrayNoZero<T>( pArena, uiCount );
+    if( pData )
+    {
+        memset( pData, 0, sizeof( T ) * uiCount );
+    }
+    return pData;
+}
+
+// -----------------------------------------------------------------------
+// -----------------------------------------------------------------------
+// Fixed capacity storage addressed through an OffsetPtr. Both the vector and its elements must
+// live in the same mapping, e.g. in the root struct of a PersistentArena.
+template <typename tElemType> struct VectorPolicyPersistent
+{
+    using ELEMTYPE = tElemType;
+
+    VectorPolicyPersistent( ELEMTYPE* pData, uint32 uiCapacity )
+        : m_pData( pData ), m_uiCapacity( uiCapacity )
+    {
+    }
+
+    ~VectorPolicyPersistent() {}
+
+    ELEMTYPE* pData() { return m_pData.get(); }
+    ELEMTYPE const* pData() const { return m_pData.get(); }
+    uint32 const size() const { return m_uiSize; }
+    uint32 const capacity() const { return m_uiCapacity; }
+    uint32 const size_committed() const { return capacity(); }
+
+    ELEMTYPE* push_new()
+    {
+        if( m_uiSize == capacity() )
+        {
+            BGASSERT( 0, "Failed to add new element. Ran out of memory." );
+            return nullptr;
+        }
+
+        new( &m_pData[m_uiSize] ) ELEMTYPE();
+        return &m_pData[m_uiSize++];
+    }
+
+    void pop_to( uint32 uiIndex )
+    {
+        if( m_uiSize == 0 )
+        {
+            BGASSERT( 0, "Failed to pop_to. Vector size is 0." );
+            return;
+        }
+
+        if( uiIndex >= size() )
+        {
+            BGASSERT( 0, "Failed to pop_to. BadIndex to pop to." );
+            return;
+        }
+
+        m_uiSize = uiIndex;
+    }
+
+    // The array lives in the mapped file
+    void shrink_to_fit() {}
+
+    OffsetPtr<ELEMTYPE> m_pData;
+    uint32 m_uiSize = 0;
+    uint32 m_uiCapacity = 0;
+};
+
+template <typename tElemType>
+using PersistentVector = Vector<VectorPolicyPersistent<tElemType>>;
+
+} // namespace Core
+} // namespace Bogus
+#endif
@@ -0,0 +1,48 @@
+#ifndef CORE_REGION_H
+#define CORE_REGION_H
+#include "Globals.h"
+
+namespace Bogus
+{
+namespace Core
+{
+static constexpr uint64 REGION_SHARED_RANGE_SIZE = GIGABYTES( 64 );
+static constexpr uint32 REGION_MAX_SHARED_RANGES = 64;
+static constexpr uint64 REGION_MIN_CAP = KILOBYTES( 64 );
+static constexpr uint64 REGION_DEFAULT_CAP = MEGABYTES( 1 );
+
+// ------------------------------------------------------
+// NOTE(asr): A growable slice of a large virtual range shared by every region in the process,
+// instead of a reservation of its own. Caps are rounded to a power of two and released regions
+// are decommitted and reused for the next region of the same cap, so creating and destroying
+// many small containers costs neither address space nor page tables. Thread safe.
+struct Region
+{
+    uint8* pBase = nullptr;
+    uint64 uiCommittedSize = 0;
+    uint64 uiCap = 0;
+};
+
+struct RegionStats
+{
+    uint64 uiRegionCount = 0;
+    uint64 uiFreeRegionCount = 0;
+    uint64 uiReservedSize = 0; // All shared ranges
+    uint64 uiCarvedSize = 0;   // Handed out to regions, live or free
+    uint64 uiCommittedSize = 0;
+};
+
+bool RegionAlloc( Region* pRegion, uint64 uiCap );
+void RegionRelease( Region* pRegion );
+// Commits at least uiSize bytes from the base, fails past the cap
+bool RegionGrow( Region* pRegion, uint64 uiSize );
+// Same, but at least doubles the commit (by no less than uiMinStepSize) while under the cap
+bool RegionGrowGeometric( Region* pRegion, uint64 uiSize, uint64 uiMinStepSize );
+// Decommits the pages past the first uiSize bytes
+void RegionShrink( Region* pRegion, uint64 uiSize );
+
+RegionStats RegionGetStats();
+
+} // namespace Core
+} // namespace Bogus
+#endif
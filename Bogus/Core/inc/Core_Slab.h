@@ -0,0 +1,48 @@
+#ifndef CORE_SLAB_H
+#define CORE_SLAB_H
+#include "Globals.h"
+#include <new>
+#include <utility>
+
+namespace Bogus
+{
+namespace Core
+{
+static constexpr uint32 SLAB_SIZE = KILOBYTES( 64 );
+static constexpr uint32 SLAB_MAX_ALLOC_SIZE = KILOBYTES( 4 );
+static constexpr uint32 SLAB_CLASS_COUNT = 16;
+static constexpr uint32 SLAB_CACHE_BATCH = 32;
+static constexpr uint32 SLAB_MIN_ALIGNMENT = 16;
+
+// NOTE(asr): Process wide size-class allocator for small objects (up to SLAB_MAX_ALLOC_SIZE).
+// Slabs are carved out of a chained Arena and never returned to the OS. Each thread keeps a free
+// list per class and only takes a lock to move SLAB_CACHE_BATCH objects to/from the shared lists.
+// Frees must pass the size used to allocate. Results are SLAB_MIN_ALIGNMENT aligned.
+void* SlabAlloc( uint64 uiSize );
+void SlabFree( void* pMem, uint64 uiSize );
+
+// Returns the calling thread's cached objects to the shared lists. Runs on thread exit too.
+void SlabFlushThreadCache();
+
+// Bytes of slabs carved for each size class so far
+void SlabGetClassUsage( uint64 ( &uiOutBytes )[SLAB_CLASS_COUNT] );
+
+template <typename T, typename... tArgs> T* SlabNew( tArgs&&... args )
+{
+    static_assert( ALIGNOF( T ) <= SLAB_MIN_ALIGNMENT, "Type is over aligned for SlabAlloc" );
+    void* pMem = SlabAlloc( sizeof( T ) );
+    return pMem ? new( pMem ) T( std::forward<tArgs>( args )... ) : nullptr;
+}
+
+template <typename T> void SlabDelete( T* pObj )
+{
+    if( pObj )
+    {
+        pObj->~T();
+        SlabFree( pObj, sizeof( T ) );
+    }
+}
+
+} // namespace Core
+} // namespace Bogus
+#endif
@@ -0,0 +1,276 @@
+#ifndef CORE_SOA_H
+#define CORE_SOA_H
+#include "Core_Arena.h"
+#include "Core_Assert.h"
+#include "Core_Vector.h"
+#include "Globals.h"
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <utility>
+
+namespace Bogus
+{
+namespace Core
+{
+static constexpr uint64 SOA_COLUMN_ALIGNMENT = 64;
+static constexpr uint32 SOA_DEFAULT_CAPACITY = 1 << 20;
+static_assert( ARENA_HEADER_SIZE % SOA_COLUMN_ALIGNMENT == 0, "Columns must start aligned" );
+
+// -----------------------------------------------------------------------
+// -----------------------------------------------------------------------
+// NOTE(asr): Struct of arrays vector, each field in tFields gets a column in an arena of its own,
+// growing like VectorPolicyArena. Columns start cache line aligned and are packed, so span<I>()
+// can be handed straight to vectorized loops that only read the fields they need.
+template <typename... tFields> struct SoAVector
+{
+    static constexpr uint32 FIELD_COUNT = sizeof...( tFields );
+    template <uint32 uiField> using FIELD = std::tuple_element_t<uiField, std::tuple<tFields...>>;
+    static_assert( FIELD_COUNT > 0, "SoAVector needs at least one field" );
+
+    explicit SoAVector( uint32 uiMaxCapacity = SOA_DEFAULT_CAPACITY )
+        : m_uiCapacity( uiMaxCapacity )
+    {
+        uint64 const pFieldSizes[] = { sizeof( tFields )... };
+        for( uint32 i = 0; i < FIELD_COUNT; ++i )
+        {
+            uint64 const uiColumnSize = uiMaxCapacity * pFieldSizes[i];
+            m_pColumns[i] = ArenaAlloc( { uiColumnSize + ARENA_HEADER_SIZE,
+                                          ARENA_DEFAULT_COMMIT_SIZE, "SoAColumn" } );
+        }
+    }
+    SoAVector( SoAVector const& ) = delete;
+    SoAVector& operator=( SoAVector const& ) = delete;
+    ~SoAVector()
+    {
+        for( Arena* pColumn : m_pColumns )
+        {
+            ArenaRelease( pColumn );
+        }
+    }
+
+    uint32 const size() const { return m_uiSize; }
+    uint32 const capacity() const { return m_uiCapacity; }
+
+    template <uint32 uiField> FIELD<uiField>* column()
+    {
+        return (FIELD<uiField>*)ArenaGetBegin( m_pColumns[uiField] );
+    }
+    template <uint32 uiField> FIELD<uiField> const* column() const
+    {
+        return (FIELD<uiField> const*)ArenaGetBegin( m_pColumns[uiField] );
+    }
+    template <uint32 uiField> std::span<FIELD<uiField>> span()
+    {
+        return { column<uiField>(), m_uiSize };
+    }
+    template <uint32 uiField> std::span<FIELD<uiField> const> span() const
+    {
+        return { column<uiField>(), m_uiSize };
+    }
+
+    template <uint32 uiField> FIELD<uiField>& get( uint32 uiIndex )
+    {
+        BGASSERT( uiIndex < m_uiSize, "" );
+        return column<uiField>()[uiIndex];
+    }
+    template <uint32 uiField> FIELD<uiField> const& get( uint32 uiIndex ) const
+    {
+        BGASSERT( uiIndex < m_uiSize, "" );
+        return column<uiField>()[uiIndex];
+    }
+
+    // Default constructs a row, returns its index or eInvalidIndex
+    uint32 push_new()
+    {
+        if( m_uiSize == m_uiCapacity )
+        {
+            BGASSERT( 0, "Failed to add new row. SoAVector ran out of memory." );
+            return eInvalidIndex;
+        }
+        PushRow( std::index_sequence_for<tFields...>() );
+        return m_uiSize++;
+    }
+
+    uint32 push( tFields const&... values )
+    {
+        uint32 const uiIndex = push_new();
+        if( uiIndex != eInvalidIndex )
+        {
+            SetRow( uiIndex, std::index_sequence_for<tFields...>(), values... );
+        }
+        return uiIndex;
+    }
+
+    void pop()
+    {
+        if( m_uiSize == 0 )
+        {
+            BGASSERT( 0, "Failed to pop. SoAVector size is 0." );
+            return;
+        }
+        --m_uiSize;
+        PopRow( std::index_sequence_for<tFields...>() );
+    }
+
+    // Moves the last row into uiIndex, order is not kept
+    void remove_swap( uint32 uiIndex )
+    {
+        if( uiIndex >= m_uiSize )
+        {
+            BGASSERT( 0, "Index OOB" );
+            return;
+        }
+        if( uiIndex != m_uiSize - 1 )
+        {
+            MoveRow( m_uiSize - 1, uiIndex, std::index_sequence_for<tFields...>() );
+        }
+        pop();
+    }
+
+    void clear()
+    {
+        while( m_uiSize )
+        {
+            pop();
+        }
+    }
+
+    void shrink_to_fit()
+    {
+        for( Arena* pColumn : m_pColumns )
+        {
+            ArenaDecommitUnused( pColumn );
+        }
+    }
+
+    enum
+    {
+        eInvalidIndex = max_uint32,
+    };
+
+  private:
+    template <size_t... uiFields> void PushRow( std::index_sequence<uiFields...> )
+    {
+        // NOTE(asr): Capacity was checked and each column reserves it, so pushes can't fail
+        ( new( ArenaPush( m_pColumns[uiFields], sizeof( FIELD<uiFields> ),
+                          alignof( FIELD<uiFields> ) ) ) FIELD<uiFields>(),
+          ... );
+    }
+
+    template <size_t... uiFields>
+    void SetRow( uint32 uiIndex, std::index_sequence<uiFields...>, tFields const&... values )
+    {
+        ( ( column<uiFields>()[uiIndex] = values ), ... );
+    }
+
+    template <size_t... uiFields> void PopRow( std::index_sequence<uiFields...> )
+    {
+        ( ( std::destroy_at( &column<uiFields>()[m_uiSize] ),
+            ArenaPop( m_pColumns[uiFields], sizeof( FIELD<uiFields> ) ) ),
+          ... );
+    }
+
+    template <size_t... uiFields>
+    void MoveRow( uint32 uiFrom, uint32 uiTo, std::index_sequence<uiFields...> )
+    {
+        ( ( column<uiFields>()[uiTo] = std::move( column<uiFields>()[uiFrom] ) ), ... );
+    }
+
+    Arena* m_pColumns[FIELD_COUNT];
+    uint32 m_uiSize = 0;
+    uint32 m_uiCapacity = 0;
+};
+
+// -----------------------------------------------------------------------
+// -----------------------------------------------------------------------
+// NOTE(asr): DenseElementPool over SoAVector columns, sharing its DenseHandleSet so the handles
+// behave the same. Rows follow the handle set's dense order so the column spans cover exactly the
+// live elements, Destroy swaps the last row into the hole. Row indices change on Destroy, handles
+// don't.
+template <typename... tFields> struct SoAElementPool
+{
+    template <uint32 uiField> using FIELD = typename SoAVector<tFields...>::template FIELD<uiField>;
+    static constexpr uint32 INVALID = max_uint32;
+
+    explicit SoAElementPool( uint32 uiMaxCapacity = SOA_DEFAULT_CAPACITY )
+        : m_Columns( MIN( uiMaxCapacity, ELEMENT_POOL_MAX_SLOTS ) )
+    {
+    }
+
+    uint32 const count() const { return m_Columns.size(); }
+    template <uint32 uiField> std::span<FIELD<uiField>> span()
+    {
+        return m_Columns.template span<uiField>();
+    }
+    uint32 GetHandleAt( uint32 uiRow ) const { return m_Handles.GetHandleAt( uiRow ); }
+
+    uint32 Create()
+    {
+        if( m_Columns.push_new() == SoAVector<tFields...>::eInvalidIndex )
+        {
+            return INVALID;
+        }
+        uint32 const uiHandle = m_Handles.Create();
+        if( uiHandle == INVALID )
+        {
+            m_Columns.pop();
+        }
+        return uiHandle;
+    }
+
+    uint32 Create( tFields const&... values )
+    {
+        uint32 const uiHandle = Create();
+        if( uiHandle != INVALID )
+        {
+            SetRow( GetRow( uiHandle ), std::index_sequence_for<tFields...>(), values... );
+        }
+        return uiHandle;
+    }
+
+    bool Destroy( uint32 uiHandle )
+    {
+        uint32 const uiRow = m_Handles.Destroy( uiHandle );
+        if( uiRow == INVALID )
+        {
+            BGASSERT( 0, "Double delete or stale handle passed in to SoAElementPool::Destroy" );
+            return false;
+        }
+        m_Columns.remove_swap( uiRow );
+        return true;
+    }
+
+    // Row of a live handle in the columns, INVALID when dead or stale
+    uint32 GetRow( uint32 uiHandle ) const { return m_Handles.GetDenseIndex( uiHandle ); }
+    bool IsValid( uint32 uiHandle ) const { return m_Handles.IsValid( uiHandle ); }
+
+    template <uint32 uiField> FIELD<uiField>* TryGet( uint32 uiHandle )
+    {
+        uint32 const uiRow = GetRow( uiHandle );
+        return uiRow != INVALID ? &m_Columns.template get<uiField>( uiRow ) : nullptr;
+    }
+
+    template <uint32 uiField> FIELD<uiField>& Get( uint32 uiHandle )
+    {
+        uint32 const uiRow = GetRow( uiHandle );
+        BGASSERT( uiRow != INVALID, "Bad pool access. Getting dead Handle." );
+        return m_Columns.template get<uiField>( uiRow );
+    }
+
+    SoAVector<tFields...> m_Columns;
+    DenseHandleSet<HeapVector<ElementPoolSlot>, HeapVector<uint32>> m_Handles;
+
+  private:
+    template <size_t... uiFields>
+    void SetRow( uint32 uiRow, std::index_sequence<uiFields...>, tFields const&... values )
+    {
+        ( ( m_Columns.template get<uiFields>( uiRow ) = values ), ... );
+    }
+};
+
+} // namespace Core
+} // namespace Bogus
+#endif
@@ -0,0 +1,84 @@
+#ifndef CORE_TLSF_H
+#define CORE_TLSF_H
+#include "Core_Memory.h"
+#include "Core_String.h"
+#include "Globals.h"
+
+namespace Bogus
+{
+namespace Core
+{
+static constexpr uint64 TLSF_DEFAULT_RESERVE_SIZE = MEGABYTES( 256 );
+static constexpr uint64 TLSF_DEFAULT_COMMIT_SIZE = KILOBYTES( 64 );
+static constexpr uint64 TLSF_ALIGNMENT = 16;
+static constexpr uint32 TLSF_SL_COUNT_LOG2 = 5;
+static constexpr uint32 TLSF_SL_COUNT = 1 << TLSF_SL_COUNT_LOG2;
+static constexpr uint32 TLSF_FL_SHIFT = TLSF_SL_COUNT_LOG2 + 4; // log2( TLSF_ALIGNMENT )
+static constexpr uint32 TLSF_FL_MAX = 38;                       // Blocks up to 256 GB
+static constexpr uint32 TLSF_FL_COUNT = TLSF_FL_MAX - TLSF_FL_SHIFT + 1;
+
+// ------------------------------------------------------
+struct TlsfAllocParams
+{
+    uint64 uiReserveSize = TLSF_DEFAULT_RESERVE_SIZE;
+    uint64 uiCommitSize = TLSF_DEFAULT_COMMIT_SIZE;
+    String::Buffer<128> name;
+    uint32 uiFlags = Memory::eMemFlag_None; // Memory::eMemFlag_* passed to Reserve/Commit
+    int32 iNumaNode = Memory::NUMA_NODE_ANY;
+};
+
+// ------------------------------------------------------
+// Physical block. Free blocks also link into their size class list through the payload.
+struct TlsfBlock
+{
+    uint64 uiPrevSize; // 0 for the first block
+    uint64 uiSize;     // Whole block size including this header, low bit set when free
+    TlsfBlock* pNextFree;
+    TlsfBlock* pPrevFree;
+};
+static constexpr uint64 TLSF_BLOCK_HEADER_SIZE = 2 * sizeof( uint64 );
+static constexpr uint64 TLSF_MIN_BLOCK_SIZE = sizeof( TlsfBlock );
+
+// ------------------------------------------------------
+// NOTE(asr): Two-Level Segregated Fit heap living at the start of its own reservation. Alloc and
+// Free are O(1): a first level per power of two split in TLSF_SL_COUNT linear second levels,
+// both found through bitmaps. Pages are committed at the end of the heap when no free block fits.
+// Not thread safe.
+struct alignas( 64 ) TlsfHeap
+{
+    TlsfAllocParams initParams;
+    uint64 uiReservedSize = 0;
+    uint64 uiCommittedSize = 0;
+    uint64 uiUsedSize = 0;
+    uint64 uiFreeSize = 0;
+    uint32 uiCommitCount = 0;
+    uint32 uiFlBitmap = 0;
+    uint32 uiSlBitmaps[TLSF_FL_COUNT] = {};
+    TlsfBlock* pFreeLists[TLSF_FL_COUNT][TLSF_SL_COUNT] = {};
+    TlsfBlock* pSentinel = nullptr;
+};
+static constexpr uint64 TLSF_HEADER_SIZE = sizeof( TlsfHeap );
+
+// ------------------------------------------------------
+struct TlsfStats
+{
+    uint64 uiUsedSize = 0;
+    uint64 uiFreeSize = 0;
+    uint64 uiLargestFreeBlock = 0;
+    uint64 uiCommittedSize = 0;
+    float fFragmentation = 0.0f; // 1 - largest free / total free
+};
+
+TlsfHeap* TlsfCreate( TlsfAllocParams const& params );
+void TlsfDestroy( TlsfHeap* pHeap );
+
+// Results are TLSF_ALIGNMENT aligned
+void* TlsfAlloc( TlsfHeap* pHeap, uint64 uiSize );
+void TlsfFree( TlsfHeap* pHeap, void* pMem );
+uint64 TlsfGetAllocSize( void* pMem );
+
+TlsfStats TlsfGetStats( TlsfHeap* pHeap );
+
+} // namespace Core
+} // namespace Bogus
+#endif
@@ -2,9 +2,11 @@
 #define CORE_VECTOR_H
 #include "Core_Arena.h"
 #include "Core_Assert.h"
+#include "Core_Region.h"
 #include "Globals.h"
+#include <bit>
 #include <cstring>
-#include <new.h>
+#include <new>
 
 namespace Bogus
 {
@@ -66,12 +68,180 @@ struct VectorPolicyArena
         m_uiSize = uiIndex;
     }
 
+    void shrink_to_fit() { ArenaDecommitUnused( m_pArena ); }
+
     uint32 m_uiFlags = 0;
     uint32 m_uiSize = 0;
     uint32 m_uiCapacity = 0;
     Arena* m_pArena;
 };
 
+// NOTE(asr): Grows in place inside a Region of the shared range, see Core_Region.h. The region is
+// taken on the first push so empty containers cost nothing.
+template <typename tElemType, uint32 uiGrowthSize = 16,
+          uint64 uiMaxCapacity = REGION_DEFAULT_CAP / sizeof( tElemType )>
+struct VectorPolicyRegion
+{
+    using ELEMTYPE = tElemType;
+
+    VectorPolicyRegion() = default;
+    VectorPolicyRegion( VectorPolicyRegion const& ) = delete;
+    VectorPolicyRegion& operator=( VectorPolicyRegion const& ) = delete;
+    ~VectorPolicyRegion() { RegionRelease( &m_Region ); }
+
+    ELEMTYPE* pData() { return (ELEMTYPE*)m_Region.pBase; }
+    ELEMTYPE const* pData() const { return (ELEMTYPE const*)m_Region.pBase; }
+    uint32 const size() const { return m_uiSize; }
+    uint32 const capacity() const { return uiMaxCapacity; }
+    uint32 const size_committed() const { return m_Region.uiCommittedSize / sizeof( ELEMTYPE ); }
+
+    ELEMTYPE* push_new()
+    {
+        if( m_uiSize == capacity() )
+        {
+            BGASSERT( 0, "Failed to add new element. Region ran out of memory." );
+            return nullptr;
+        }
+
+        uint64 const uiNeededSize = ( m_uiSize + 1 ) * sizeof( ELEMTYPE );
+        if( uiNeededSize > m_Region.uiCommittedSize )
+        {
+            if( !m_Region.pBase && !RegionAlloc( &m_Region, uiMaxCapacity * sizeof( ELEMTYPE ) ) )
+            {
+                return nullptr;
+            }
+
+            uint64 const uiMinStepSize = uiGrowthSize * sizeof( ELEMTYPE );
+            if( !RegionGrowGeometric( &m_Region, uiNeededSize, uiMinStepSize ) )
+            {
+                return nullptr;
+            }
+        }
+
+        new( &pData()[m_uiSize] ) ELEMTYPE();
+        return &pData()[m_uiSize++];
+    }
+
+    void pop_to( uint32 uiIndex )
+    {
+        if( m_uiSize == 0 )
+        {
+            BGASSERT( 0, "Failed to pop_to. Vector size is 0." );
+            return;
+        }
+
+        if( uiIndex >= size() )
+        {
+            BGASSERT( 0, "Failed to pop_to. BadIndex to pop to." );
+            return;
+        }
+
+        m_uiSize = uiIndex;
+    }
+
+    void shrink_to_fit() { RegionShrink( &m_Region, m_uiSize * sizeof( ELEMTYPE ) ); }
+
+    Region m_Region;
+    uint32 m_uiSize = 0;
+};
+
+// NOTE(asr): Keeps the first uiInlineCapacity elements inside the container and spills them to a
+// Region on overflow, staying there after. Elements are moved with memcpy when spilling.
+template <typename tElemType, uint32 uiInlineCapacity, uint32 uiGrowthSize = 16,
+          uint64 uiMaxCapacity = REGION_DEFAULT_CAP / sizeof( tElemType )>
+struct VectorPolicySmall
+{
+    using ELEMTYPE = tElemType;
+    static_assert( uiInlineCapacity > 0 && uiInlineCapacity < uiMaxCapacity,
+                   "Inline capacity must be below the max capacity" );
+
+    VectorPolicySmall() = default;
+    VectorPolicySmall( VectorPolicySmall const& ) = delete;
+    VectorPolicySmall& operator=( VectorPolicySmall const& ) = delete;
+    ~VectorPolicySmall() { RegionRelease( &m_Region ); }
+
+    ELEMTYPE* pData() { return m_Region.pBase ? (ELEMTYPE*)m_Region.pBase : (ELEMTYPE*)m_Inline; }
+    ELEMTYPE const* pData() const
+    {
+        return m_Region.pBase ? (ELEMTYPE const*)m_Region.pBase : (ELEMTYPE const*)m_Inline;
+    }
+    uint32 const size() const { return m_uiSize; }
+    uint32 const capacity() const { return uiMaxCapacity; }
+    uint32 const size_committed() const
+    {
+        return m_Region.pBase ? m_Region.uiCommittedSize / sizeof( ELEMTYPE ) : uiInlineCapacity;
+    }
+    bool const spilled() const { return m_Region.pBase != nullptr; }
+
+    ELEMTYPE* push_new()
+    {
+        if( m_uiSize == capacity() )
+        {
+            BGASSERT( 0, "Failed to add new element. Small vector ran out of memory." );
+            return nullptr;
+        }
+
+        if( !m_Region.pBase && m_uiSize == uiInlineCapacity && !Spill() )
+        {
+            return nullptr;
+        }
+
+        uint64 const uiNeededSize = ( m_uiSize + 1 ) * sizeof( ELEMTYPE );
+        if( m_Region.pBase && uiNeededSize > m_Region.uiCommittedSize )
+        {
+            uint64 const uiMinStepSize = uiGrowthSize * sizeof( ELEMTYPE );
+            if( !RegionGrowGeometric( &m_Region, uiNeededSize, uiMinStepSize ) )
+            {
+                return nullptr;
+            }
+        }
+
+        new( &pData()[m_uiSize] ) ELEMTYPE();
+        return &pData()[m_uiSize++];
+    }
+
+    void pop_to( uint32 uiIndex )
+    {
+        if( m_uiSize == 0 )
+        {
+            BGASSERT( 0, "Failed to pop_to. Vector size is 0." );
+            return;
+        }
+
+        if( uiIndex >= size() )
+        {
+            BGASSERT( 0, "Failed to pop_to. BadIndex to pop to." );
+            return;
+        }
+
+        m_uiSize = uiIndex;
+    }
+
+    // Stays spilled, only decommits the region's unused pages
+    void shrink_to_fit() { RegionShrink( &m_Region, m_uiSize * sizeof( ELEMTYPE ) ); }
+
+    bool Spill()
+    {
+        if( !RegionAlloc( &m_Region, uiMaxCapacity * sizeof( ELEMTYPE ) ) )
+        {
+            return false;
+        }
+
+        uint64 const uiInlineSize = uiInlineCapacity * sizeof( ELEMTYPE );
+        if( !RegionGrowGeometric( &m_Region, uiInlineSize + sizeof( ELEMTYPE ), uiInlineSize ) )
+        {
+            RegionRelease( &m_Region );
+            return false;
+        }
+        memcpy( m_Region.pBase, m_Inline, uiInlineSize );
+        return true;
+    }
+
+    alignas( ELEMTYPE ) uint8 m_Inline[uiInlineCapacity * sizeof( ELEMTYPE )];
+    Region m_Region;
+    uint32 m_uiSize = 0;
+};
+
 template <typename tElemType> struct VectorPolicyPreAllocated
 {
     using ELEMTYPE = tElemType;
@@ -118,6 +288,8 @@ template <typename tElemType> struct VectorPolicyPreAllocated
         m_uiSize = uiIndex;
     }
 
+    void shrink_to_fit() {}
+
     ELEMTYPE* m_pData;
     uint32 m_uiSize = 0;
     uint32 m_uiCapacity = 0;
@@ -165,6 +337,8 @@ template <typename tElemType, uint32 uiCapacity> struct VectorPolicyStatic
         m_uiSize = uiIndex;
     }
 
+    void shrink_to_fit() {}
+
     ELEMTYPE m_Data[uiCapacity];
     uint32 m_uiSize = 0;
 };
@@ -178,6 +352,7 @@ template <typename tElemAllocator> struct Vector : tElemAllocator
     using tElemAllocator::pData;
     using tElemAllocator::pop_to;
     using tElemAllocator::push_new;
+    using tElemAllocator::shrink_to_fit;
     using tElemAllocator::size;
     using tElemAllocator::size_committed;
     enum
@@ -258,6 +433,15 @@ template <typename tElemType, uint32 uiGrowthSize = 16,
           uint64 uiDesiredCapacity = ARENA_DEFAULT_RESERVE_SIZE / sizeof( tElemType )>
 using HeapVector = Vector<VectorPolicyArena<tElemType, uiGrowthSize, uiDesiredCapacity>>;
 
+template <typename tElemType, uint32 uiGrowthSize = 16,
+          uint64 uiMaxCapacity = REGION_DEFAULT_CAP / sizeof( tElemType )>
+using RegionVector = Vector<VectorPolicyRegion<tElemType, uiGrowthSize, uiMaxCapacity>>;
+
+template <typename tElemType, uint32 uiInlineCapacity = 8, uint32 uiGrowthSize = 16,
+          uint64 uiMaxCapacity = REGION_DEFAULT_CAP / sizeof( tElemType )>
+using SmallVector =
+    Vector<VectorPolicySmall<tElemType, uiInlineCapacity, uiGrowthSize, uiMaxCapacity>>;
+
 template <typename tElemType> using ArenaVector = Vector<VectorPolicyPreAllocated<tElemType>>;
 
 template <typename tElemType, uint32 uiCapacity>
@@ -265,53 +449,83 @@ using StaticVector = Vector<VectorPolicyStatic<tElemType, uiCapacity>>;
 
 // -----------------------------------------------------------------------
 // -----------------------------------------------------------------------
+// NOTE(asr): Pool handles pack the slot index in the low bits and the slot's generation in the high
+// ones. The generation moves on every Destroy, so handles to a reused slot stop resolving (until
+// the slot has been reused 256 times and the generation wraps).
+static constexpr uint32 ELEMENT_POOL_INDEX_BITS = 24;
+static constexpr uint32 ELEMENT_POOL_INDEX_MASK = ( 1u << ELEMENT_POOL_INDEX_BITS ) - 1;
+static constexpr uint32 ELEMENT_POOL_MAX_SLOTS = ELEMENT_POOL_INDEX_MASK; // Never makes INVALID
+
+// Per slot metadata, kept apart from the elements so liveness checks never touch them
+struct ElementPoolSlot
+{
+    bool const alive() const { return uiGeneration & 1; }
+    uint32 const handle( uint32 uiIndex ) const
+    {
+        return ( ( uiGeneration >> 1 ) << ELEMENT_POOL_INDEX_BITS ) | uiIndex;
+    }
+
+    uint32 uiGeneration = 0; // Odd while alive
+    uint32 uiNext = 0;       // Next free slot while dead, dense index while alive in a dense pool
+    uint32 uiPrev = 0;       // Previous free slot while dead, lets Compact unlink any free slot
+};
+
+struct ElementPoolRemap
+{
+    uint32 uiOldHandle;
+    uint32 uiNewHandle;
+};
+
+// -----------------------------------------------------------------------
+// -----------------------------------------------------------------------
+// NOTE(asr): tStorage is the Vector holding the elements, e.g. RegionVector for many small pools.
+// Elements stay at their slot index so pointers to them are stable, until a Compact moves them.
+// Slots past the end of tStorage were trimmed by Compact, they keep their generation so handles
+// into the trimmed tail stay dead once it is reused.
 template <typename tElemType, uint32 uiGrowthSize = 16,
-          uint64 uiDesiredCapacity = ARENA_DEFAULT_RESERVE_SIZE / sizeof( tElemType )>
+          uint64 uiDesiredCapacity = ARENA_DEFAULT_RESERVE_SIZE / sizeof( tElemType ),
+          typename tStorage = HeapVector<tElemType, uiGrowthSize, uiDesiredCapacity>,
+          typename tSlotStorage = HeapVector<ElementPoolSlot, uiGrowthSize, uiDesiredCapacity>>
 struct ElementPool
 {
     using ELEMTYPE = tElemType;
     static constexpr uint32 INVALID = max_uint32;
-    static constexpr uint32 DEAD_ENTRY = 0xdeadffff;
-
-    struct DeadEntry
-    {
-        uint32 uiDeadMark = DEAD_ENTRY;
-        uint32 uiNextFree = INVALID;
-    };
-    static_assert( sizeof( ELEMTYPE ) >= sizeof( DeadEntry ),
-                   "Element size must be bigger than DeadEntry" );
 
     ElementPool() = default;
 
+    // Scans the slot metadata only, func( uiHandle, pElement )
     template <typename tFunc> void ForEachElement( tFunc func )
     {
         for( uint32 i = 0; i < m_Vec.size(); ++i )
         {
-            DeadEntry* pEntry = reinterpret_cast<DeadEntry*>( &m_Vec[i] );
-            if( pEntry->uiDeadMark == DEAD_ENTRY )
+            if( m_Slots[i].alive() )
             {
-                continue;
+                func( m_Slots[i].handle( i ), &m_Vec[i] );
             }
-
-            func( i, &m_Vec[i] );
         }
     }
 
     uint32 Create()
     {
-        // Reuse a dead entry if available
+        // Reuse a dead slot if available
         if( m_uiNextFree != INVALID )
         {
-            uint32 uiReusedHandle = m_uiNextFree;
+            uint32 const uiIndex = m_uiNextFree;
+            ElementPoolSlot& slot = m_Slots[uiIndex];
+            BGASSERT( !slot.alive(), "Free slot is alive." );
+            Unlink( uiIndex );
+            ++slot.uiGeneration;
 
-            // Patch up m_uiNextFree
-            DeadEntry* pEntry = reinterpret_cast<DeadEntry*>( &m_Vec[uiReusedHandle] );
-            BGASSERT( pEntry->uiDeadMark == DEAD_ENTRY, "Free handle is not marked dead." );
-            m_uiNextFree = pEntry->uiNextFree;
-
-            new( &m_Vec[uiReusedHandle] ) ELEMTYPE();
+            new( &m_Vec[uiIndex] ) ELEMTYPE();
             ++m_uiCount;
-            return uiReusedHandle;
+            return slot.handle( uiIndex );
+        }
+
+        uint32 const uiIndex = m_Vec.size();
+        if( uiIndex == ELEMENT_POOL_MAX_SLOTS )
+        {
+            BGASSERT( 0, "ElementPool ran out of handle indices." );
+            return INVALID;
         }
 
         ELEMTYPE* pNew = m_Vec.push_new();
@@ -320,75 +534,408 @@ struct ElementPool
             return INVALID;
         }
 
+        if( uiIndex == m_Slots.size() && !m_Slots.push_new() )
+        {
+            m_Vec.pop();
+            return INVALID;
+        }
+
+        ElementPoolSlot& slot = m_Slots[uiIndex];
+        ++slot.uiGeneration;
         ++m_uiCount;
-        return m_Vec.size() - 1;
+        return slot.handle( uiIndex );
     }
 
     bool Destroy( uint32 uiHandle )
     {
-        if( uiHandle >= m_Vec.size() )
+        uint32 const uiIndex = uiHandle & ELEMENT_POOL_INDEX_MASK;
+        if( uiIndex >= m_Slots.size() )
         {
             BGASSERT( 0, "Bad Handle passed in to ElementPool::Destroy" );
             return false;
         }
 
-        DeadEntry* pEntry = reinterpret_cast<DeadEntry*>( &m_Vec[uiHandle] );
-        if( pEntry->uiDeadMark == DEAD_ENTRY )
+        ElementPoolSlot& slot = m_Slots[uiIndex];
+        if( !slot.alive() )
         {
             BGASSERT( 0, "Double delete. Handle is already dead." );
             return false;
         }
 
-        pEntry->uiDeadMark = DEAD_ENTRY;
-        pEntry->uiNextFree = m_uiNextFree;
-        m_uiNextFree = uiHandle;
+        if( slot.handle( uiIndex ) != uiHandle )
+        {
+            BGASSERT( 0, "Stale handle passed in to ElementPool::Destroy" );
+            return false;
+        }
+
+        m_Vec[uiIndex].~ELEMTYPE();
+        ++slot.uiGeneration;
+        Link( uiIndex );
+        m_uiCompactCursor = MIN( m_uiCompactCursor, uiIndex );
         --m_uiCount;
         return true;
     }
 
-    ELEMTYPE* Get( uint32 uiHandle )
+    bool IsValid( uint32 uiHandle ) const
     {
-        if( uiHandle >= m_Vec.size() )
+        uint32 const uiIndex = uiHandle & ELEMENT_POOL_INDEX_MASK;
+        if( uiIndex >= m_Slots.size() )
         {
-            BGASSERT( 0, "Bad handle when getting data from handle." );
-            return nullptr;
+            return false;
         }
-        DeadEntry* pEntry = reinterpret_cast<DeadEntry*>( &m_Vec[uiHandle] );
-        BGASSERT( pEntry->uiDeadMark != DEAD_ENTRY, "Bad pool access. Getting dead Handle." );
-        return &m_Vec[uiHandle];
+        ElementPoolSlot const& slot = m_Slots[uiIndex];
+        return slot.alive() && slot.handle( uiIndex ) == uiHandle;
     }
 
-    ELEMTYPE* TryGet( uint32 uiHandle )
+    ELEMTYPE* Get( uint32 uiHandle )
     {
-        if( uiHandle >= m_Vec.size() )
+        if( ( uiHandle & ELEMENT_POOL_INDEX_MASK ) >= m_Slots.size() )
         {
+            BGASSERT( 0, "Bad handle when getting data from handle." );
             return nullptr;
         }
-        DeadEntry* pEntry = reinterpret_cast<DeadEntry*>( &m_Vec[uiHandle] );
-        if( pEntry->uiDeadMark == DEAD_ENTRY )
+        if( !IsValid( uiHandle ) )
         {
+            BGASSERT( 0, "Bad pool access. Getting dead Handle." );
             return nullptr;
         }
-        return &m_Vec[uiHandle];
+        return &m_Vec[uiHandle & ELEMENT_POOL_INDEX_MASK];
+    }
+
+    ELEMTYPE* TryGet( uint32 uiHandle )
+    {
+        return IsValid( uiHandle ) ? &m_Vec[uiHandle & ELEMENT_POOL_INDEX_MASK] : nullptr;
     }
 
     ELEMTYPE& operator[]( uint32 const uiHandle ) { return *Get( uiHandle ); }
     ELEMTYPE const& operator[]( uint32 const uiHandle ) const { return *Get( uiHandle ); }
     uint32 const count() const { return m_uiCount; }
 
-    HeapVector<ELEMTYPE, uiGrowthSize, uiDesiredCapacity> m_Vec;
+    // NOTE(asr): Incremental defragmentation. Moves up to uiMaxMoves live elements from the top of
+    // the pool into the lowest dead slots, writing the handle change of each to pOutRemaps (room
+    // for uiMaxMoves), then trims the dead tail and decommits the storage past it. Returns the
+    // number of moves, call it again on later frames until it returns 0. Moved handles go stale.
+    // Slices that leave the size alone don't decommit, so a growing pool keeps its commit.
+    uint32 Compact( uint32 uiMaxMoves, ElementPoolRemap* pOutRemaps )
+    {
+        uint32 const uiOldSize = m_Vec.size();
+        uint32 uiMoves = 0;
+        TrimDeadTail();
+        while( uiMoves < uiMaxMoves )
+        {
+            // NOTE(asr): After trimming the last slot is alive, so any dead slot lies below it
+            while( m_uiCompactCursor < m_Vec.size() && m_Slots[m_uiCompactCursor].alive() )
+            {
+                ++m_uiCompactCursor;
+            }
+            if( m_uiCompactCursor >= m_Vec.size() )
+            {
+                break;
+            }
+
+            uint32 const uiTo = m_uiCompactCursor;
+            uint32 const uiFrom = m_Vec.size() - 1;
+            ElementPoolSlot& toSlot = m_Slots[uiTo];
+            ElementPoolSlot& fromSlot = m_Slots[uiFrom];
+            Unlink( uiTo );
+            ++toSlot.uiGeneration;
+            new( &m_Vec[uiTo] ) ELEMTYPE( static_cast<ELEMTYPE&&>( m_Vec[uiFrom] ) );
+            m_Vec[uiFrom].~ELEMTYPE();
+
+            pOutRemaps[uiMoves++] = { fromSlot.handle( uiFrom ), toSlot.handle( uiTo ) };
+            ++fromSlot.uiGeneration;
+            Link( uiFrom );
+            TrimDeadTail();
+        }
+
+        if( m_Vec.size() < uiOldSize )
+        {
+            m_Vec.shrink_to_fit();
+        }
+        return uiMoves;
+    }
+
+    bool const compacted() const { return m_uiCount == m_Vec.size(); }
+
+    tStorage m_Vec;
+    tSlotStorage m_Slots;
     uint32 m_uiNextFree = INVALID;
     uint32 m_uiCount = 0;
+    uint32 m_uiCompactCursor = 0; // No dead slot below it
+
+  private:
+    // Free slots form a doubly linked list so Compact can take any of them
+    void Link( uint32 uiIndex )
+    {
+        ElementPoolSlot& slot = m_Slots[uiIndex];
+        slot.uiPrev = INVALID;
+        slot.uiNext = m_uiNextFree;
+        if( m_uiNextFree != INVALID )
+        {
+            m_Slots[m_uiNextFree].uiPrev = uiIndex;
+        }
+        m_uiNextFree = uiIndex;
+    }
+
+    void Unlink( uint32 uiIndex )
+    {
+        ElementPoolSlot const& slot = m_Slots[uiIndex];
+        if( slot.uiPrev != INVALID )
+        {
+            m_Slots[slot.uiPrev].uiNext = slot.uiNext;
+        }
+        else
+        {
+            m_uiNextFree = slot.uiNext;
+        }
+        if( slot.uiNext != INVALID )
+        {
+            m_Slots[slot.uiNext].uiPrev = slot.uiPrev;
+        }
+    }
+
+    void TrimDeadTail()
+    {
+        uint32 uiNewSize = m_Vec.size();
+        while( uiNewSize && !m_Slots[uiNewSize - 1].alive() )
+        {
+            Unlink( --uiNewSize );
+        }
+        if( uiNewSize < m_Vec.size() )
+        {
+            m_Vec.pop_to( uiNewSize );
+        }
+        m_uiCompactCursor = MIN( m_uiCompactCursor, uiNewSize );
+    }
+};
+
+template <typename tElemType, uint32 uiGrowthSize = 16,
+          uint64 uiMaxCapacity = REGION_DEFAULT_CAP / sizeof( tElemType )>
+using RegionElementPool =
+    ElementPool<tElemType, uiGrowthSize, uiMaxCapacity,
+                RegionVector<tElemType, uiGrowthSize, uiMaxCapacity>,
+                RegionVector<ElementPoolSlot, uiGrowthSize, uiMaxCapacity>>;
+
+// -----------------------------------------------------------------------
+// -----------------------------------------------------------------------
+// NOTE(asr): Handle side of a sparse set, shared by the dense pools. Slots hand out ElementPool
+// handles and point at a dense index, m_DenseToIndex points back. Owners keep their elements
+// packed in the same order: push an element then Create its handle, and on Destroy move the last
+// element into the returned dense index then pop it.
+template <typename tSlotStorage, typename tIndexStorage> struct DenseHandleSet
+{
+    static constexpr uint32 INVALID = max_uint32;
+
+    uint32 const count() const { return m_DenseToIndex.size(); }
+
+    uint32 GetHandleAt( uint32 uiDenseIndex ) const
+    {
+        uint32 const uiIndex = m_DenseToIndex[uiDenseIndex];
+        return m_Slots[uiIndex].handle( uiIndex );
+    }
+
+    // Dense index of a live handle, INVALID when dead or stale
+    uint32 GetDenseIndex( uint32 uiHandle ) const
+    {
+        uint32 const uiIndex = uiHandle & ELEMENT_POOL_INDEX_MASK;
+        if( uiIndex >= m_Slots.size() )
+        {
+            return INVALID;
+        }
+        ElementPoolSlot const& slot = m_Slots[uiIndex];
+        return slot.alive() && slot.handle( uiIndex ) == uiHandle ? slot.uiNext : INVALID;
+    }
+
+    bool IsValid( uint32 uiHandle ) const { return GetDenseIndex( uiHandle ) != INVALID; }
+
+    // Handle for the element at dense index count(), INVALID when out of memory or indices
+    uint32 Create()
+    {
+        uint32* pDenseToIndex = m_DenseToIndex.push_new();
+        if( !pDenseToIndex )
+        {
+            return INVALID;
+        }
+
+        // Reuse a dead slot if available
+        uint32 uiIndex = m_uiNextFree;
+        if( uiIndex != INVALID )
+        {
+            m_uiNextFree = m_Slots[uiIndex].uiNext;
+        }
+        else if( m_Slots.size() < ELEMENT_POOL_MAX_SLOTS && m_Slots.push_new() )
+        {
+            uiIndex = m_Slots.size() - 1;
+        }
+        else
+        {
+            BGASSERT( m_Slots.size() < ELEMENT_POOL_MAX_SLOTS,
+                      "ElementPool ran out of handle indices." );
+            m_DenseToIndex.pop();
+            return INVALID;
+        }
+
+        ElementPoolSlot& slot = m_Slots[uiIndex];
+        BGASSERT( !slot.alive(), "Free slot is alive." );
+        *pDenseToIndex = uiIndex;
+        slot.uiNext = m_DenseToIndex.size() - 1;
+        ++slot.uiGeneration;
+        return slot.handle( uiIndex );
+    }
+
+    // Dense index the owner has to fill with its last element, INVALID for a dead or stale handle
+    uint32 Destroy( uint32 uiHandle )
+    {
+        uint32 const uiDenseIndex = GetDenseIndex( uiHandle );
+        if( uiDenseIndex == INVALID )
+        {
+            return INVALID;
+        }
+
+        uint32 const uiIndex = uiHandle & ELEMENT_POOL_INDEX_MASK;
+        uint32 const uiLastDenseIndex = m_DenseToIndex.size() - 1;
+        if( uiDenseIndex != uiLastDenseIndex )
+        {
+            uint32 const uiMovedIndex = m_DenseToIndex[uiLastDenseIndex];
+            m_DenseToIndex[uiDenseIndex] = uiMovedIndex;
+            m_Slots[uiMovedIndex].uiNext = uiDenseIndex;
+        }
+        m_DenseToIndex.pop();
+
+        ElementPoolSlot& slot = m_Slots[uiIndex];
+        ++slot.uiGeneration;
+        slot.uiNext = m_uiNextFree;
+        m_uiNextFree = uiIndex;
+        return uiDenseIndex;
+    }
+
+    tSlotStorage m_Slots;
+    tIndexStorage m_DenseToIndex;
+    uint32 m_uiNextFree = INVALID;
+};
+
+// -----------------------------------------------------------------------
+// -----------------------------------------------------------------------
+// NOTE(asr): Sparse set flavour of ElementPool with the same handles. Live elements are kept packed
+// at the front of tStorage in the dense order of m_Handles, and Destroy moves the last element into
+// the hole. Iteration only touches live elements but element pointers are invalidated by any
+// Destroy.
+template <typename tElemType, uint32 uiGrowthSize = 16,
+          uint64 uiDesiredCapacity = ARENA_DEFAULT_RESERVE_SIZE / sizeof( tElemType ),
+          typename tStorage = HeapVector<tElemType, uiGrowthSize, uiDesiredCapacity>,
+          typename tSlotStorage = HeapVector<ElementPoolSlot, uiGrowthSize, uiDesiredCapacity>,
+          typename tIndexStorage = HeapVector<uint32, uiGrowthSize, uiDesiredCapacity>>
+struct DenseElementPool
+{
+    using ELEMTYPE = tElemType;
+    using iterator = ELEMTYPE*;
+    static constexpr uint32 INVALID = max_uint32;
+
+    DenseElementPool() = default;
+
+    iterator begin() { return m_Vec.begin(); }
+    iterator end() { return m_Vec.end(); }
+
+    // func( uiHandle, pElement ), in dense order
+    template <typename tFunc> void ForEachElement( tFunc func )
+    {
+        for( uint32 i = 0; i < m_Vec.size(); ++i )
+        {
+            func( GetHandleAt( i ), &m_Vec[i] );
+        }
+    }
+
+    uint32 GetHandleAt( uint32 uiDenseIndex ) const
+    {
+        return m_Handles.GetHandleAt( uiDenseIndex );
+    }
+
+    uint32 Create()
+    {
+        if( !m_Vec.push_new() )
+        {
+            return INVALID;
+        }
+        uint32 const uiHandle = m_Handles.Create();
+        if( uiHandle == INVALID )
+        {
+            m_Vec.pop();
+        }
+        return uiHandle;
+    }
+
+    bool Destroy( uint32 uiHandle )
+    {
+        uint32 const uiDenseIndex = m_Handles.Destroy( uiHandle );
+        if( uiDenseIndex == INVALID )
+        {
+            BGASSERT( 0, "Double delete or stale handle passed in to DenseElementPool::Destroy" );
+            return false;
+        }
+
+        uint32 const uiLastDenseIndex = m_Vec.size() - 1;
+        if( uiDenseIndex != uiLastDenseIndex )
+        {
+            m_Vec[uiDenseIndex] = m_Vec[uiLastDenseIndex];
+        }
+        m_Vec[uiLastDenseIndex].~ELEMTYPE();
+        m_Vec.pop();
+        return true;
+    }
+
+    bool IsValid( uint32 uiHandle ) const { return m_Handles.IsValid( uiHandle ); }
+
+    ELEMTYPE* Get( uint32 uiHandle )
+    {
+        uint32 const uiDenseIndex = m_Handles.GetDenseIndex( uiHandle );
+        if( uiDenseIndex == INVALID )
+        {
+            BGASSERT( 0, "Bad pool access. Getting dead Handle." );
+            return nullptr;
+        }
+        return &m_Vec[uiDenseIndex];
+    }
+
+    ELEMTYPE* TryGet( uint32 uiHandle )
+    {
+        uint32 const uiDenseIndex = m_Handles.GetDenseIndex( uiHandle );
+        return uiDenseIndex != INVALID ? &m_Vec[uiDenseIndex] : nullptr;
+    }
+
+    ELEMTYPE& operator[]( uint32 const uiHandle ) { return *Get( uiHandle ); }
+    uint32 const count() const { return m_Vec.size(); }
+
+    tStorage m_Vec;
+    DenseHandleSet<tSlotStorage, tIndexStorage> m_Handles;
 };
 
 // -----------------------------------------------------------------------
 // -----------------------------------------------------------------------
+template <typename tQueue, typename tElemType> struct QueueIterator
+{
+    tElemType& operator*() const { return ( *pQueue )[uiIndex]; }
+    tElemType* operator->() const { return &( *pQueue )[uiIndex]; }
+    bool operator!=( QueueIterator const& other ) const { return uiIndex != other.uiIndex; }
+    bool operator==( QueueIterator const& other ) const { return uiIndex == other.uiIndex; }
+    QueueIterator& operator++()
+    {
+        ++uiIndex;
+        return *this;
+    }
+
+    tQueue* pQueue;
+    uint32 uiIndex;
+};
+
+// NOTE(asr): Ring buffer over the allocator's elements, which it only ever grows to a power of two
+// slot count so head and tail wrap with a mask. Growing doubles the slots and moves the wrapped
+// part past the old end, the only time elements are moved. Elements are moved with memcpy.
 template <typename tElemAllocator> struct Queue : tElemAllocator
 {
     using ELEMTYPE = tElemAllocator::ELEMTYPE;
     using tElemAllocator::capacity;
-    using tElemAllocator::size;
     using tElemAllocator::size_committed;
+    static constexpr uint32 MIN_SLOTS = 8;
     enum
     {
         eInvalidIndex = max_uint32,
@@ -400,87 +947,146 @@ template <typename tElemAllocator> struct Queue : tElemAllocator
     using tElemAllocator::push_new;
 
   public:
-    using iterator = ELEMTYPE*;
-    using const_iterator = ELEMTYPE const*;
-    iterator begin() { return pData() + m_uiHead; }
-    iterator end() { return pData() + m_uiHead + size(); }
-    const_iterator begin() const { return pData() + m_uiHead; }
-    const_iterator end() const { return pData() + m_uiHead + size(); }
-
-    ELEMTYPE& Raw( uint32 const uiIndex )
+    using iterator = QueueIterator<Queue, ELEMTYPE>;
+    using const_iterator = QueueIterator<Queue const, ELEMTYPE const>;
+    iterator begin() { return { this, 0 }; }
+    iterator end() { return { this, m_uiCount }; }
+    const_iterator begin() const { return { this, 0 }; }
+    const_iterator end() const { return { this, m_uiCount }; }
+
+    // Slot in the ring, regardless of the head
+    ELEMTYPE& Raw( uint32 const uiSlot )
     {
-        BGASSERT( uiIndex < size(), "" );
-        return pData()[uiIndex];
+        BGASSERT( uiSlot < slots(), "" );
+        return pData()[uiSlot];
     }
-    ELEMTYPE const& Raw( uint32 const uiIndex ) const
+    ELEMTYPE const& Raw( uint32 const uiSlot ) const
     {
-        BGASSERT( uiIndex < size(), "" );
-        return pData()[uiIndex];
+        BGASSERT( uiSlot < slots(), "" );
+        return pData()[uiSlot];
     }
 
-    ELEMTYPE& operator[]( uint32 uiIndex )
+    ELEMTYPE& operator[]( uint32 const uiIndex )
     {
-        uiIndex += m_uiHead;
-        return Raw( uiIndex );
+        BGASSERT( uiIndex < m_uiCount, "" );
+        return pData()[( m_uiHead + uiIndex ) & ( slots() - 1 )];
     }
-    ELEMTYPE const& operator[]( uint32 uiIndex ) const
+    ELEMTYPE const& operator[]( uint32 const uiIndex ) const
     {
-        uiIndex += m_uiHead;
-        BGASSERT( uiIndex < size(), "" );
-        return Raw( uiIndex );
+        BGASSERT( uiIndex < m_uiCount, "" );
+        return pData()[( m_uiHead + uiIndex ) & ( slots() - 1 )];
     }
 
-    ELEMTYPE& front() { return pData()[m_uiHead]; }
-    ELEMTYPE& back() { return pData()[size() - 1]; }
-    ELEMTYPE const& front() const { return pData()[m_uiHead]; }
-    ELEMTYPE const& back() const { return pData()[size() - 1]; }
+    ELEMTYPE& front() { return ( *this )[0]; }
+    ELEMTYPE& back() { return ( *this )[m_uiCount - 1]; }
+    ELEMTYPE const& front() const { return ( *this )[0]; }
+    ELEMTYPE const& back() const { return ( *this )[m_uiCount - 1]; }
 
-    uint32 count() const { return size() - m_uiHead; }
+    uint32 count() const { return m_uiCount; }
+    uint32 slots() const { return tElemAllocator::size(); }
 
     void push( ELEMTYPE const& in_Element )
     {
-        ELEMTYPE* pNewElement = push_new();
-        if( pNewElement )
+        if( m_uiCount == slots() && !Grow( m_uiCount + 1 ) )
         {
-            *pNewElement = in_Element;
+            return;
+        }
+
+        pData()[( m_uiHead + m_uiCount ) & ( slots() - 1 )] = in_Element;
+        ++m_uiCount;
+    }
+
+    // Pushes all or nothing, in at most two copies
+    bool push_n( ELEMTYPE const* pElements, uint32 uiNum )
+    {
+        if( m_uiCount + uiNum > slots() && !Grow( m_uiCount + uiNum ) )
+        {
+            return false;
+        }
+
+        uint32 const uiTail = ( m_uiHead + m_uiCount ) & ( slots() - 1 );
+        uint32 const uiFirstNum = MIN( uiNum, slots() - uiTail );
+        memcpy( (void*)( pData() + uiTail ), pElements, sizeof( ELEMTYPE ) * uiFirstNum );
+        memcpy( (void*)pData(), pElements + uiFirstNum,
+                sizeof( ELEMTYPE ) * ( uiNum - uiFirstNum ) );
+        m_uiCount += uiNum;
+        return true;
+    }
+
+    void pop()
+    {
+        if( m_uiCount == 0 )
+        {
+            BGASSERT( 0, "Failed to pop. Queue is empty." );
+            return;
+        }
+
+        m_uiHead = ( m_uiHead + 1 ) & ( slots() - 1 );
+        --m_uiCount;
+    }
+
+    // Pops up to uiNum elements into pOutElements (if not null), returns how many were popped
+    uint32 pop_n( ELEMTYPE* pOutElements, uint32 uiNum )
+    {
+        uiNum = MIN( uiNum, m_uiCount );
+        if( uiNum == 0 )
+        {
+            return 0;
+        }
+
+        uint32 const uiFirstNum = MIN( uiNum, slots() - m_uiHead );
+        if( pOutElements )
+        {
+            memcpy( (void*)pOutElements, pData() + m_uiHead, sizeof( ELEMTYPE ) * uiFirstNum );
+            memcpy( (void*)( pOutElements + uiFirstNum ), pData(),
+                    sizeof( ELEMTYPE ) * ( uiNum - uiFirstNum ) );
         }
+        m_uiHead = ( m_uiHead + uiNum ) & ( slots() - 1 );
+        m_uiCount -= uiNum;
+        return uiNum;
+    }
+
+    void clear()
+    {
+        m_uiHead = 0;
+        m_uiCount = 0;
     }
 
     uint32 find( ELEMTYPE const& in_data ) const
     {
-        for( uint32 i = m_uiHead; i < size(); ++i )
+        for( uint32 i = 0; i < m_uiCount; ++i )
         {
-            if( pData[i] == in_data )
+            if( ( *this )[i] == in_data )
                 return i;
         }
         return eInvalidIndex;
     }
 
+    // NOTE(asr): Shifts whichever side of uiIndex is shorter
     void remove( uint32 uiIndex )
     {
-        if( uiIndex >= size() || uiIndex < m_uiHead )
+        if( uiIndex >= m_uiCount )
         {
             BGASSERT( 0, "Index OOB" );
             return;
         }
 
-        for( uint32 i = uiIndex; i < size() - 1; ++i )
+        if( uiIndex < m_uiCount / 2 )
         {
-            pData[i] = pData[i + 1];
+            for( uint32 i = uiIndex; i > 0; --i )
+            {
+                ( *this )[i] = ( *this )[i - 1];
+            }
+            m_uiHead = ( m_uiHead + 1 ) & ( slots() - 1 );
         }
-        pop_to( size() - 1 );
-    }
-
-    void pop()
-    {
-        uint32 const uiHalfSize = size_committed() / 2;
-        if( ++m_uiHead == uiHalfSize )
+        else
         {
-            uint32 const uiNumElems = count();
-            memcpy( pData(), pData() + uiHalfSize, sizeof( ELEMTYPE ) * uiNumElems );
-            pop_to( uiNumElems );
-            m_uiHead = 0;
+            for( uint32 i = uiIndex; i < m_uiCount - 1; ++i )
+            {
+                ( *this )[i] = ( *this )[i + 1];
+            }
         }
+        --m_uiCount;
     }
 
     void remove_elem( ELEMTYPE const& kElem )
@@ -494,13 +1100,52 @@ template <typename tElemAllocator> struct Queue : tElemAllocator
         remove( uiIndex );
     }
 
+    bool Grow( uint32 uiMinSlots )
+    {
+        uint32 const uiOldSlots = slots();
+        uint32 const uiMaxSlots = std::bit_floor( capacity() );
+        uint32 const uiWantedSlots = MAX( uiMinSlots, uiOldSlots * 2 );
+        uint32 const uiNewSlots = std::bit_ceil( MAX( uiWantedSlots, MIN_SLOTS ) );
+        if( uiMinSlots > uiMaxSlots )
+        {
+            BGASSERT( 0, "Failed to grow queue. Ran out of memory." );
+            return false;
+        }
+
+        uint32 const uiTargetSlots = MIN( uiNewSlots, uiMaxSlots );
+        while( tElemAllocator::size() < uiTargetSlots )
+        {
+            if( !push_new() )
+            {
+                if( tElemAllocator::size() > uiOldSlots )
+                {
+                    pop_to( uiOldSlots );
+                }
+                return false;
+            }
+        }
+
+        // NOTE(asr): The new slots are at least as many as the old, so the wrapped part fits
+        if( m_uiHead + m_uiCount > uiOldSlots )
+        {
+            uint32 const uiWrappedNum = m_uiHead + m_uiCount - uiOldSlots;
+            memcpy( (void*)( pData() + uiOldSlots ), pData(), sizeof( ELEMTYPE ) * uiWrappedNum );
+        }
+        return true;
+    }
+
     uint32 m_uiHead = 0;
+    uint32 m_uiCount = 0;
 };
 
 template <typename tElemType, uint32 uiGrowthSize = 16,
           uint64 uiDesiredCapacity = ARENA_DEFAULT_RESERVE_SIZE / sizeof( tElemType )>
 using HeapQueue = Queue<VectorPolicyArena<tElemType, uiGrowthSize, uiDesiredCapacity>>;
 
+template <typename tElemType, uint32 uiGrowthSize = 16,
+          uint64 uiMaxCapacity = REGION_DEFAULT_CAP / sizeof( tElemType )>
+using RegionQueue = Queue<VectorPolicyRegion<tElemType, uiGrowthSize, uiMaxCapacity>>;
+
 template <typename tElemType> using ArenaQueue = Queue<VectorPolicyPreAllocated<tElemType>>;
 
 template <typename tElemType, uint32 uiCapacity>
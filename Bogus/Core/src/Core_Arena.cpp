@@ -1,53 +1,248 @@
 #include "Core_Arena.h"
+#include "Core_ArenaRegistry.h"
 #include "Core_Assert.h"
 #include "Core_Memory.h"
 #include "Core_Utility.h"
 #include "Globals.h"
+#include <bit>
+#include <mutex>
+#include <string.h>
 
 namespace Bogus
 {
 namespace Core
 {
+thread_local static Arena* s_pScratchArenas[ARENA_SCRATCH_COUNT] = {};
+thread_local static Arena* s_pLocalNodeArena = nullptr;
+
+struct ArenaCacheEntry
+{
+    uint8* pMem;
+    uint64 uiCommittedSize;
+};
+
+struct ArenaCache
+{
+    std::mutex mutex;
+    ArenaCacheParams params;
+    ArenaCacheEntry entries[64][ARENA_CACHE_MAX_PER_CLASS];
+    uint32 uiCounts[64] = {};
+    uint64 uiHits = 0;
+    uint64 uiMisses = 0;
+};
+static ArenaCache s_ArenaCache;
 
 // ------------------------------------------------------
 // ------------------------------------------------------
-Arena* ArenaAlloc( ArenaAllocParams const& params )
+static bool ArenaCanRecycle( ArenaAllocParams const& params )
 {
-    uint64 const uiPageSize = Memory::GetPageSize();
+    return !( params.uiArenaFlags & eArenaFlag_NoRecycle ) &&
+           params.uiFlags == Memory::eMemFlag_None && params.iNumaNode == Memory::NUMA_NODE_ANY;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+static uint8* ArenaCachePop( uint64 uiReserveSize, uint64* pOutCommittedSize )
+{
+    uint32 const uiClass = std::countr_zero( uiReserveSize );
+    std::lock_guard<std::mutex> lock( s_ArenaCache.mutex );
+    uint32& uiCount = s_ArenaCache.uiCounts[uiClass];
+    if( !uiCount )
+    {
+        ++s_ArenaCache.uiMisses;
+        return nullptr;
+    }
+
+    ++s_ArenaCache.uiHits;
+    ArenaCacheEntry const& entry = s_ArenaCache.entries[uiClass][--uiCount];
+    *pOutCommittedSize = entry.uiCommittedSize;
+    return entry.pMem;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+static void ArenaReleaseBlock( Arena* pBlock )
+{
+    uint64 const uiReservedSize = pBlock->uiReservedSize;
+    if( !ArenaCanRecycle( pBlock->initParams ) )
+    {
+        Memory::Release( pBlock, uiReservedSize, pBlock->initParams.uiFlags );
+        return;
+    }
+
+    // NOTE(asr): Recyclable blocks were reserved as their whole size class, see ArenaAllocBlock
+    uint64 const uiClassSize = std::bit_ceil( uiReservedSize );
+    uint64 uiCommittedSize = AlignSize( pBlock->uiCommittedSize, Memory::GetPageSize() );
+    uint32 const uiClass = std::countr_zero( uiClassSize );
+    {
+        std::lock_guard<std::mutex> lock( s_ArenaCache.mutex );
+        uint32& uiCount = s_ArenaCache.uiCounts[uiClass];
+        ArenaCacheParams const& params = s_ArenaCache.params;
+        if( uiCount < params.uiMaxPerClass && uiCount < ARENA_CACHE_MAX_PER_CLASS )
+        {
+            uint64 const uiRetain = AlignSize( params.uiMaxRetainedCommit, Memory::GetPageSize() );
+            if( uiCommittedSize > uiRetain )
+            {
+                Memory::Decommit( (uint8*)pBlock + uiRetain, uiCommittedSize - uiRetain );
+                uiCommittedSize = uiRetain;
+            }
+            s_ArenaCache.entries[uiClass][uiCount++] = { (uint8*)pBlock, uiCommittedSize };
+            return;
+        }
+    }
+    Memory::Release( pBlock, uiClassSize );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void ArenaCacheConfigure( ArenaCacheParams const& params )
+{
+    std::lock_guard<std::mutex> lock( s_ArenaCache.mutex );
+    s_ArenaCache.params = params;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+ArenaCacheStats ArenaCacheGetStats()
+{
+    std::lock_guard<std::mutex> lock( s_ArenaCache.mutex );
+    ArenaCacheStats stats;
+    stats.uiHits = s_ArenaCache.uiHits;
+    stats.uiMisses = s_ArenaCache.uiMisses;
+    for( uint32 uiClass = 0; uiClass < 64; ++uiClass )
+    {
+        for( uint32 i = 0; i < s_ArenaCache.uiCounts[uiClass]; ++i )
+        {
+            stats.uiCachedCommittedSize += s_ArenaCache.entries[uiClass][i].uiCommittedSize;
+            ++stats.uiCachedCount;
+        }
+    }
+    return stats;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void ArenaCacheTrim()
+{
+    std::lock_guard<std::mutex> lock( s_ArenaCache.mutex );
+    for( uint32 uiClass = 0; uiClass < 64; ++uiClass )
+    {
+        for( uint32 i = 0; i < s_ArenaCache.uiCounts[uiClass]; ++i )
+        {
+            Memory::Release( s_ArenaCache.entries[uiClass][i].pMem, 1ull << uiClass );
+        }
+        s_ArenaCache.uiCounts[uiClass] = 0;
+    }
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+static Arena* ArenaAllocBlock( ArenaAllocParams const& params )
+{
+    bool const bLargePages =
+        params.uiFlags & ( Memory::eMemFlag_LargePages | Memory::eMemFlag_HugeTLB );
+    uint64 const uiPageSize = bLargePages ? Memory::GetLargePageSize() : Memory::GetPageSize();
     uint64 const uiReserveSize = ALIGNUP_POW2( params.uiReserveSize, uiPageSize );
     uint64 const uiCommitSize = ALIGNUP_POW2( params.uiCommitSize, uiPageSize );
 
-    uint8* pMem = (uint8*)Memory::Reserve( uiReserveSize );
-    Memory::Commit( pMem, uiCommitSize );
+    // NOTE(asr): Recyclable blocks reserve their whole power of two size class so any cached
+    // block fits any request of its class. The arena still reports the size that was asked for.
+    bool const bRecycle = ArenaCanRecycle( params );
+    uint64 const uiBlockSize = bRecycle ? std::bit_ceil( uiReserveSize ) : uiReserveSize;
+    uint8* pMem = nullptr;
+    uint64 uiCommittedSize = 0;
+    if( bRecycle )
+    {
+        pMem = ArenaCachePop( uiBlockSize, &uiCommittedSize );
+        if( uiCommittedSize > uiReserveSize )
+        {
+            Memory::Decommit( pMem + uiReserveSize, uiCommittedSize - uiReserveSize );
+            uiCommittedSize = uiReserveSize;
+        }
+    }
+
+    if( pMem == 0 )
+    {
+        pMem = (uint8*)Memory::Reserve( uiBlockSize, params.uiFlags, params.iNumaNode );
+    }
     if( pMem == 0 )
     {
         BGASSERT( 0, "Failed to Reserve pMemory" );
         return nullptr;
     }
 
+    // NOTE(asr): Recycled pages keep whatever the last owner wrote to them
+    uint64 const uiDirtySize = uiCommittedSize;
+    uint32 uiCommitCount = 0;
+    if( uiCommittedSize < uiCommitSize )
+    {
+        Memory::Commit( pMem + uiCommittedSize, uiCommitSize - uiCommittedSize, params.uiFlags );
+        uiCommittedSize = uiCommitSize;
+        uiCommitCount = 1;
+    }
+
     Arena* pArena = (Arena*)pMem;
     pArena->initParams = params;
+    // NOTE(asr): Keep growth in whole large pages so the kernel can back them with huge pages
+    pArena->initParams.uiCommitSize = bLargePages ? uiCommitSize : params.uiCommitSize;
     pArena->uiPos = ARENA_HEADER_SIZE;
     pArena->uiBasePos = pArena->uiPos;
     pArena->uiReservedSize = uiReserveSize;
-    pArena->uiCommittedSize = uiCommitSize;
+    pArena->uiCommittedSize = uiCommittedSize;
+    pArena->uiCommitCount = uiCommitCount;
+    pArena->uiDecommitCount = 0;
+    pArena->uiHighWaterPos = 0;
+    pArena->uiZeroPos = uiDirtySize;
+    pArena->uiPeakPos = 0;
+    pArena->uiPushCount = 0;
+    pArena->uiChainedPos = 0;
+    pArena->uiChainedCommittedSize = 0;
+    pArena->uiChainedReservedSize = 0;
+    pArena->uiChainedCommitCount = 0;
+    pArena->uiChainedDecommitCount = 0;
+    pArena->uiChainedBlockCount = 0;
+    pArena->pRegistryPrev = nullptr;
+    pArena->pRegistryNext = nullptr;
+    pArena->pCurrent = pArena;
+    pArena->pPrev = nullptr;
+    pArena->uiChainBasePos = 0;
     ArenaPush( pArena, 0, ALIGNOF( Arena ) );
 
     return pArena;
 }
 
+// ------------------------------------------------------
+// ------------------------------------------------------
+Arena* ArenaAlloc( ArenaAllocParams const& params )
+{
+    Arena* pArena = ArenaAllocBlock( params );
+    if( pArena )
+    {
+        ArenaRegistryAdd( pArena );
+    }
+    return pArena;
+}
+
 // ------------------------------------------------------
 // ------------------------------------------------------
 void ArenaRelease( Arena* pArena )
 {
-    Memory::Release( pArena, pArena->uiReservedSize );
+    ArenaRegistryRemove( pArena );
+    Arena* pBlock = pArena->pCurrent;
+    while( pBlock )
+    {
+        Arena* pPrev = pBlock->pPrev;
+        ArenaReleaseBlock( pBlock );
+        pBlock = pPrev;
+    }
 }
 
 // ------------------------------------------------------
 // ------------------------------------------------------
 uint64 ArenaGetPos( Arena* pArena )
 {
-    return pArena->uiPos;
+    Arena* pCurrent = pArena->pCurrent;
+    return pCurrent->uiChainBasePos + pCurrent->uiPos;
 }
 
 // ------------------------------------------------------
@@ -57,22 +252,96 @@ uint8* ArenaGetBegin( Arena* pArena )
     return (uint8*)pArena + pArena->uiBasePos;
 }
 
+// ------------------------------------------------------
+// ------------------------------------------------------
+static Arena* ArenaChainBlock( Arena* pArena, uint64 uiSize, uint64 uiAlignment )
+{
+    Arena* pCurrent = pArena->pCurrent;
+    ArenaAllocParams params = pArena->initParams;
+    uint64 const uiNeededSize = ARENA_HEADER_SIZE + uiAlignment + uiSize;
+    uint64 const uiBlockSize = MAX( params.uiReserveSize, uiNeededSize );
+    params.uiReserveSize = Memory::GetReservedSize( uiBlockSize, params.uiFlags );
+
+    Arena* pBlock = ArenaAllocBlock( params );
+    if( !pBlock )
+    {
+        return nullptr;
+    }
+
+    pBlock->pPrev = pCurrent;
+    pBlock->uiChainBasePos = pCurrent->uiChainBasePos + pCurrent->uiReservedSize;
+    pArena->pCurrent = pBlock;
+    pArena->uiChainedPos = pBlock->uiChainBasePos + pBlock->uiPos;
+    pArena->uiChainedCommittedSize += pBlock->uiCommittedSize;
+    pArena->uiChainedReservedSize += pBlock->uiReservedSize;
+    pArena->uiChainedCommitCount += pBlock->uiCommitCount;
+    ++pArena->uiChainedBlockCount;
+    return pBlock;
+}
+
 // ------------------------------------------------------
 // ------------------------------------------------------
 uint8* ArenaPush( Arena* pArena, uint64 uiSize, uint64 uiAlignment )
 {
+    uint64 uiDirtySize = 0;
+    return ArenaPush( pArena, uiSize, uiAlignment, &uiDirtySize );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint8* ArenaPushZero( Arena* pArena, uint64 uiSize, uint64 uiAlignment )
+{
+    uint64 uiDirtySize = 0;
+    uint8* pMem = ArenaPush( pArena, uiSize, uiAlignment, &uiDirtySize );
+    if( pMem && uiDirtySize )
+    {
+        memset( pMem, 0, uiDirtySize );
+    }
+    return pMem;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint8* ArenaPush( Arena* pArena, uint64 uiSize, uint64 uiAlignment, uint64* pOutDirtySize )
+{
+    Arena* const pHandle = pArena;
+    if( pArena->initParams.uiArenaFlags & eArenaFlag_Chained )
+    {
+        Arena* pCurrent = pArena->pCurrent;
+        if( ALIGNUP_POW2( pCurrent->uiPos, uiAlignment ) + uiSize > pCurrent->uiReservedSize )
+        {
+            pCurrent = ArenaChainBlock( pArena, uiSize, uiAlignment );
+            if( !pCurrent )
+            {
+                BGASSERT( 0, "Failed to chain a new arena block" );
+                return nullptr;
+            }
+        }
+        pArena = pCurrent;
+    }
+
     uint64 uiCurrentPos = ALIGNUP_POW2( pArena->uiPos, uiAlignment );
     uint64 uiNewPos = uiCurrentPos + uiSize;
 
     // NOTE(asr): Commit new pages if necessary
     if( pArena->uiCommittedSize < uiNewPos )
     {
-        uint64 uiNewCommitSizeAligned = AlignSize( uiNewPos, pArena->initParams.uiCommitSize );
+        ArenaAllocParams const& params = pArena->initParams;
+        uint64 uiStep = MIN( pArena->uiCommittedSize, params.uiMaxCommitStep );
+        uiStep = MAX( uiStep, params.uiCommitSize );
+        uint64 const uiTargetPos = MAX( uiNewPos, pArena->uiCommittedSize + uiStep );
+        uint64 uiNewCommitSizeAligned = AlignSize( uiTargetPos, params.uiCommitSize );
         uint64 uiNewCommitSizeClamped = MIN( uiNewCommitSizeAligned, pArena->uiReservedSize );
         uint64 uiCommitSize = uiNewCommitSizeClamped - pArena->uiCommittedSize;
         uint8* pCommitted = (uint8*)pArena + pArena->uiCommittedSize;
-        Memory::Commit( pCommitted, uiCommitSize );
+        Memory::Commit( pCommitted, uiCommitSize, params.uiFlags );
         pArena->uiCommittedSize = uiNewCommitSizeClamped;
+        ++pArena->uiCommitCount;
+        if( pArena != pHandle )
+        {
+            pHandle->uiChainedCommittedSize += uiCommitSize;
+            ++pHandle->uiChainedCommitCount;
+        }
     }
 
     uint8* pMem = 0;
@@ -80,6 +349,23 @@ uint8* ArenaPush( Arena* pArena, uint64 uiSize, uint64 uiAlignment )
     {
         pMem = (uint8*)pArena + uiCurrentPos;
         pArena->uiPos = uiNewPos;
+
+        // NOTE(asr): Anything below uiZeroPos may have been written since it was committed
+        uint64 const uiZeroPos = pArena->uiZeroPos;
+        if( uiNewPos > uiZeroPos )
+        {
+            *pOutDirtySize = uiZeroPos > uiCurrentPos ? uiZeroPos - uiCurrentPos : 0;
+            pArena->uiZeroPos = uiNewPos;
+        }
+        else
+        {
+            *pOutDirtySize = uiSize;
+        }
+
+        uint64 const uiGlobalPos = pArena->uiChainBasePos + uiNewPos;
+        pHandle->uiPeakPos = MAX( pHandle->uiPeakPos, uiGlobalPos );
+        pHandle->uiChainedPos = uiGlobalPos;
+        ++pHandle->uiPushCount;
     }
 
     if( pMem == 0 )
@@ -94,10 +380,64 @@ uint8* ArenaPush( Arena* pArena, uint64 uiSize, uint64 uiAlignment )
 // ------------------------------------------------------
 void ArenaPopTo( Arena* pArena, uint64 uiPos )
 {
+    Arena* const pHandle = pArena;
+    if( pArena->pCurrent != pArena )
+    {
+        // NOTE(asr): Free every trailing block that the position no longer reaches into
+        Arena* pCurrent = pArena->pCurrent;
+        while( pCurrent->pPrev && uiPos < pCurrent->uiChainBasePos + pCurrent->uiBasePos )
+        {
+            Arena* pPrev = pCurrent->pPrev;
+            pHandle->uiChainedCommittedSize -= pCurrent->uiCommittedSize;
+            pHandle->uiChainedReservedSize -= pCurrent->uiReservedSize;
+            pHandle->uiChainedCommitCount -= pCurrent->uiCommitCount;
+            pHandle->uiChainedDecommitCount -= pCurrent->uiDecommitCount;
+            --pHandle->uiChainedBlockCount;
+            pArena->pCurrent = pPrev;
+            ArenaReleaseBlock( pCurrent );
+            pCurrent = pPrev;
+        }
+        pArena = pCurrent;
+        uiPos -= pCurrent->uiChainBasePos;
+    }
+
     BGASSERT( pArena->uiPos >= uiPos, "Attempting to pop memory that is already popped." );
     BGASSERT( uiPos < pArena->uiCommittedSize, "Attempting to pop memory that is not committed" );
     uiPos = MAX( ARENA_HEADER_SIZE, uiPos );
+    uint64 const uiOldPos = pArena->uiPos;
     pArena->uiPos = uiPos;
+    pHandle->uiChainedPos = pArena->uiChainBasePos + uiPos;
+
+    if( pArena->initParams.uiDecommitThreshold >= pArena->uiCommittedSize )
+    {
+        return;
+    }
+
+    // NOTE(asr): Nothing pops between two pops, so the old position is the peak since the last one
+    uint64 uiHighWater = pArena->uiHighWaterPos;
+    if( uiHighWater > uiPos )
+    {
+        uiHighWater -= ( uiHighWater - uiPos ) >> pArena->initParams.uiDecommitDecayShift;
+    }
+    uiHighWater = MAX( uiHighWater, uiOldPos );
+    pArena->uiHighWaterPos = uiHighWater;
+
+    uint64 const uiKeep = MAX( pArena->initParams.uiDecommitThreshold, uiHighWater );
+    uint64 const uiKeepAligned = AlignSize(
+        AlignSize( uiKeep, pArena->initParams.uiCommitSize ), Memory::GetPageSize() );
+    uint64 const uiCommittedEnd = AlignSize( pArena->uiCommittedSize, Memory::GetPageSize() );
+    if( uiKeepAligned < uiCommittedEnd )
+    {
+        Memory::Decommit( (uint8*)pArena + uiKeepAligned, uiCommittedEnd - uiKeepAligned );
+        if( pArena != pHandle )
+        {
+            pHandle->uiChainedCommittedSize -= pArena->uiCommittedSize - uiKeepAligned;
+            ++pHandle->uiChainedDecommitCount;
+        }
+        pArena->uiCommittedSize = uiKeepAligned;
+        pArena->uiZeroPos = MIN( pArena->uiZeroPos, uiKeepAligned );
+        ++pArena->uiDecommitCount;
+    }
 }
 
 // ------------------------------------------------------
@@ -120,5 +460,99 @@ void ArenaClear( Arena* pArena )
     ArenaPopTo( pArena, 0 );
 }
 
+// ------------------------------------------------------
+// ------------------------------------------------------
+void ArenaDecommitUnused( Arena* pArena )
+{
+    // NOTE(asr): Keep whole commit units like ArenaPopTo, large page arenas commit 2MB at a time
+    Arena* pBlock = pArena->pCurrent;
+    uint64 const uiPageSize = Memory::GetPageSize();
+    uint64 const uiKeepAligned =
+        AlignSize( AlignSize( pBlock->uiPos, pBlock->initParams.uiCommitSize ), uiPageSize );
+    uint64 const uiCommittedEnd = AlignSize( pBlock->uiCommittedSize, uiPageSize );
+    if( uiKeepAligned < uiCommittedEnd )
+    {
+        Memory::Decommit( (uint8*)pBlock + uiKeepAligned, uiCommittedEnd - uiKeepAligned );
+        if( pBlock != pArena )
+        {
+            pArena->uiChainedCommittedSize -= pBlock->uiCommittedSize - uiKeepAligned;
+            ++pArena->uiChainedDecommitCount;
+        }
+        pBlock->uiCommittedSize = uiKeepAligned;
+        pBlock->uiZeroPos = MIN( pBlock->uiZeroPos, uiKeepAligned );
+        pBlock->uiHighWaterPos = pBlock->uiPos;
+        ++pBlock->uiDecommitCount;
+    }
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+ArenaTemp GetScratch( Arena* const* ppConflicts, uint32 uiConflictCount )
+{
+    for( uint32 i = 0; i < ARENA_SCRATCH_COUNT; ++i )
+    {
+        Arena*& pScratch = s_pScratchArenas[i];
+        if( !pScratch )
+        {
+            pScratch = NEW_ARENA(.name = "ScratchArena" );
+        }
+
+        bool bConflict = false;
+        for( uint32 j = 0; j < uiConflictCount; ++j )
+        {
+            if( ppConflicts[j] == pScratch )
+            {
+                bConflict = true;
+                break;
+            }
+        }
+
+        if( !bConflict )
+        {
+            return ArenaTemp( pScratch );
+        }
+    }
+
+    BGASSERT( 0, "All scratch arenas conflict. Increase ARENA_SCRATCH_COUNT." );
+    return ArenaTemp( s_pScratchArenas[0] );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void ReleaseScratch()
+{
+    for( Arena*& pScratch : s_pScratchArenas )
+    {
+        if( pScratch )
+        {
+            ArenaRelease( pScratch );
+            pScratch = nullptr;
+        }
+    }
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+Arena* GetLocalNodeArena()
+{
+    if( !s_pLocalNodeArena )
+    {
+        s_pLocalNodeArena =
+            NEW_ARENA(.name = "LocalNodeArena", .iNumaNode = (int32)Memory::GetCurrentNumaNode() );
+    }
+    return s_pLocalNodeArena;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void ReleaseLocalNodeArena()
+{
+    if( s_pLocalNodeArena )
+    {
+        ArenaRelease( s_pLocalNodeArena );
+        s_pLocalNodeArena = nullptr;
+    }
+}
+
 } // namespace Core
 } // namespace Bogus
@@ -0,0 +1,184 @@
+#include "Core_ArenaRegistry.h"
+#include "Core_Arena.h"
+#include "Globals.h"
+#include <mutex>
+#include <stdarg.h>
+#include <stdio.h>
+
+namespace Bogus
+{
+namespace Core
+{
+static std::mutex s_RegistryMutex;
+static Arena* s_pRegistryHead = nullptr;
+
+// INTERNALS (DECLS) -------------------------------------------------------------------------------
+struct DumpWriter
+{
+    char* pBuffer;
+    uint64 uiBufferSize;
+    uint64 uiLen;
+};
+static void DumpWrite( DumpWriter& writer, char const* szFormat, ... );
+static void DumpWriteStats( DumpWriter& writer, ArenaStats const& stats, ArenaDumpFormat format,
+                            bool bFirst );
+// INTERNALS (DECLS) -------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+void ArenaRegistryAdd( Arena* pArena )
+{
+    std::lock_guard<std::mutex> lock( s_RegistryMutex );
+    pArena->pRegistryPrev = nullptr;
+    pArena->pRegistryNext = s_pRegistryHead;
+    if( s_pRegistryHead )
+    {
+        s_pRegistryHead->pRegistryPrev = pArena;
+    }
+    s_pRegistryHead = pArena;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+void ArenaRegistryRemove( Arena* pArena )
+{
+    std::lock_guard<std::mutex> lock( s_RegistryMutex );
+    if( pArena->pRegistryPrev )
+    {
+        pArena->pRegistryPrev->pRegistryNext = pArena->pRegistryNext;
+    }
+    else if( s_pRegistryHead == pArena )
+    {
+        s_pRegistryHead = pArena->pRegistryNext;
+    }
+
+    if( pArena->pRegistryNext )
+    {
+        pArena->pRegistryNext->pRegistryPrev = pArena->pRegistryPrev;
+    }
+    pArena->pRegistryPrev = nullptr;
+    pArena->pRegistryNext = nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+ArenaStats ArenaGetStats( Arena* pArena )
+{
+    ArenaStats stats;
+    stats.name = pArena->initParams.name;
+    stats.uiPos = pArena->pCurrent == pArena ? pArena->uiPos : pArena->uiChainedPos;
+    stats.uiPeakPos = pArena->uiPeakPos;
+    stats.uiPushCount = pArena->uiPushCount;
+    stats.uiCommittedSize = pArena->uiCommittedSize + pArena->uiChainedCommittedSize;
+    stats.uiReservedSize = pArena->uiReservedSize + pArena->uiChainedReservedSize;
+    stats.uiCommitCount = pArena->uiCommitCount + pArena->uiChainedCommitCount;
+    stats.uiDecommitCount = pArena->uiDecommitCount + pArena->uiChainedDecommitCount;
+    stats.uiBlockCount = 1 + pArena->uiChainedBlockCount;
+    return stats;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+uint32 ArenaRegistryGetStats( ArenaStats* pOutStats, uint32 uiMaxCount )
+{
+    std::lock_guard<std::mutex> lock( s_RegistryMutex );
+    uint32 uiCount = 0;
+    for( Arena* pArena = s_pRegistryHead; pArena; pArena = pArena->pRegistryNext )
+    {
+        if( uiCount < uiMaxCount )
+        {
+            pOutStats[uiCount] = ArenaGetStats( pArena );
+        }
+        ++uiCount;
+    }
+    return uiCount;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+uint64 ArenaRegistryDump( char* pBuffer, uint64 uiBufferSize, ArenaDumpFormat format )
+{
+    DumpWriter writer = { pBuffer, uiBufferSize, 0 };
+    if( pBuffer && uiBufferSize )
+    {
+        pBuffer[0] = 0;
+    }
+
+    if( format == ArenaDumpFormat::JSON )
+    {
+        DumpWrite( writer, "[" );
+    }
+    else
+    {
+        DumpWrite( writer, "name,pos,peak_pos,committed,reserved,push_count,commit_count,"
+                           "decommit_count,block_count\n" );
+    }
+
+    std::lock_guard<std::mutex> lock( s_RegistryMutex );
+    for( Arena* pArena = s_pRegistryHead; pArena; pArena = pArena->pRegistryNext )
+    {
+        DumpWriteStats( writer, ArenaGetStats( pArena ), format, pArena == s_pRegistryHead );
+    }
+
+    if( format == ArenaDumpFormat::JSON )
+    {
+        DumpWrite( writer, "\n]\n" );
+    }
+    return writer.uiLen;
+}
+
+// INTERNALS (IMPLS) -------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+static void DumpWrite( DumpWriter& writer, char const* szFormat, ... )
+{
+    uint64 const uiRemaining =
+        writer.uiLen < writer.uiBufferSize ? writer.uiBufferSize - writer.uiLen : 0;
+    char* pDest = uiRemaining ? writer.pBuffer + writer.uiLen : nullptr;
+
+    va_list args;
+    va_start( args, szFormat );
+    int const iWritten = vsnprintf( pDest, uiRemaining, szFormat, args );
+    va_end( args );
+
+    if( iWritten > 0 )
+    {
+        writer.uiLen += iWritten;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void DumpWriteStats( DumpWriter& writer, ArenaStats const& stats, ArenaDumpFormat format,
+                            bool bFirst )
+{
+    // NOTE(asr): Names are user strings, keep them from breaking the output format
+    char szName[String::Buffer<128>::eCapacity + 1];
+    uint32 uiNameLen = 0;
+    for( uint32 i = 0; i < stats.name.m_uiLen; ++i )
+    {
+        char const c = stats.name.m_pData[i];
+        szName[uiNameLen++] = ( c == '"' || c == '\\' || c == ',' || c < ' ' ) ? '_' : c;
+    }
+    szName[uiNameLen] = 0;
+
+    if( format == ArenaDumpFormat::JSON )
+    {
+        DumpWrite( writer,
+                   "%s\n  {\"name\": \"%s\", \"pos\": %llu, \"peak_pos\": %llu, "
+                   "\"committed\": %llu, \"reserved\": %llu, \"push_count\": %llu, "
+                   "\"commit_count\": %u, \"decommit_count\": %u, \"block_count\": %u}",
+                   bFirst ? "" : ",", szName, stats.uiPos, stats.uiPeakPos, stats.uiCommittedSize,
+                   stats.uiReservedSize, stats.uiPushCount, stats.uiCommitCount,
+                   stats.uiDecommitCount, stats.uiBlockCount );
+    }
+    else
+    {
+        DumpWrite( writer, "%s,%llu,%llu,%llu,%llu,%llu,%u,%u,%u\n", szName, stats.uiPos,
+                   stats.uiPeakPos, stats.uiCommittedSize, stats.uiReservedSize,
+                   stats.uiPushCount, stats.uiCommitCount, stats.uiDecommitCount,
+                   stats.uiBlockCount );
+    }
+}
+// INTERNALS (IMPLS) -------------------------------------------------------------------------------
+
+} // namespace Core
+} // namespace Bogus
@@ -0,0 +1,131 @@
+#include "Core_ConcurrentArena.h"
+#include "Core_Assert.h"
+#include "Core_Memory.h"
+#include "Core_Utility.h"
+#include "Globals.h"
+#include <new>
+#include <thread>
+
+namespace Bogus
+{
+namespace Core
+{
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+ConcurrentArena* ConcurrentArenaAlloc( ArenaAllocParams const& params )
+{
+    uint64 const uiPageSize = Memory::GetPageSize();
+    uint64 const uiReserveSize = ALIGNUP_POW2( params.uiReserveSize, uiPageSize );
+    uint64 const uiMinCommitSize = MAX( params.uiCommitSize, CONCURRENT_ARENA_HEADER_SIZE );
+    uint64 const uiCommitSize = ALIGNUP_POW2( uiMinCommitSize, uiPageSize );
+
+    uint8* pMem = (uint8*)Memory::Reserve( uiReserveSize, params.uiFlags, params.iNumaNode );
+    if( pMem == 0 )
+    {
+        BGASSERT( 0, "Failed to Reserve pMemory" );
+        return nullptr;
+    }
+    Memory::Commit( pMem, uiCommitSize, params.uiFlags );
+
+    ConcurrentArena* pArena = new( pMem ) ConcurrentArena();
+    pArena->initParams = params;
+    pArena->uiBasePos = CONCURRENT_ARENA_HEADER_SIZE;
+    pArena->uiReservedSize = uiReserveSize;
+    pArena->uiPos.store( CONCURRENT_ARENA_HEADER_SIZE, std::memory_order_relaxed );
+    pArena->uiCommitCount.store( 1, std::memory_order_relaxed );
+    pArena->uiCommittedSize.store( uiCommitSize, std::memory_order_release );
+    return pArena;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void ConcurrentArenaRelease( ConcurrentArena* pArena )
+{
+    uint64 const uiReservedSize = pArena->uiReservedSize;
+    uint32 const uiFlags = pArena->initParams.uiFlags;
+    pArena->~ConcurrentArena();
+    Memory::Release( pArena, uiReservedSize, uiFlags );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint64 ConcurrentArenaGetPos( ConcurrentArena* pArena )
+{
+    return pArena->uiPos.load( std::memory_order_relaxed );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint8* ConcurrentArenaGetBegin( ConcurrentArena* pArena )
+{
+    return (uint8*)pArena + pArena->uiBasePos;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+static void ConcurrentArenaCommitTo( ConcurrentArena* pArena, uint64 uiEndPos )
+{
+    while( pArena->uiCommittedSize.load( std::memory_order_acquire ) < uiEndPos )
+    {
+        uint32 uiUnlocked = 0;
+        if( !pArena->uiCommitLock.compare_exchange_weak( uiUnlocked, 1,
+                                                         std::memory_order_acquire ) )
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // NOTE(asr): Another winner may have committed past us while we took the lock
+        uint64 const uiCommitted = pArena->uiCommittedSize.load( std::memory_order_relaxed );
+        if( uiCommitted < uiEndPos )
+        {
+            uint64 const uiCommitStep = pArena->initParams.uiCommitSize;
+            uint64 uiNewCommitSizeAligned = AlignSize( uiEndPos, uiCommitStep );
+            uint64 uiNewCommitSizeClamped = MIN( uiNewCommitSizeAligned, pArena->uiReservedSize );
+            Memory::Commit( (uint8*)pArena + uiCommitted, uiNewCommitSizeClamped - uiCommitted,
+                            pArena->initParams.uiFlags );
+            pArena->uiCommitCount.fetch_add( 1, std::memory_order_relaxed );
+            pArena->uiCommittedSize.store( uiNewCommitSizeClamped, std::memory_order_release );
+        }
+        pArena->uiCommitLock.store( 0, std::memory_order_release );
+    }
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint8* ConcurrentArenaPush( ConcurrentArena* pArena, uint64 uiSize, uint64 uiAlignment )
+{
+    // NOTE(asr): Bigger alignments reserve worst case padding so we never need a CAS loop, rounded
+    // up like the rest so the next push still starts aligned
+    uint64 const uiPadded = uiAlignment <= CONCURRENT_ARENA_MIN_ALIGNMENT
+                                ? uiSize
+                                : uiSize + uiAlignment - 1;
+    uint64 const uiReserve = ALIGNUP_POW2( uiPadded, CONCURRENT_ARENA_MIN_ALIGNMENT );
+    uint64 const uiOldPos = pArena->uiPos.fetch_add( uiReserve, std::memory_order_relaxed );
+    uint64 const uiCurrentPos = ALIGNUP_POW2( uiOldPos, uiAlignment );
+    uint64 const uiNewPos = uiCurrentPos + uiSize;
+
+    if( uiNewPos > pArena->uiReservedSize )
+    {
+        BGASSERT( 0, "Failed to allocate memory" );
+        return nullptr;
+    }
+
+    if( pArena->uiCommittedSize.load( std::memory_order_acquire ) < uiNewPos )
+    {
+        ConcurrentArenaCommitTo( pArena, uiNewPos );
+    }
+
+    return (uint8*)pArena + uiCurrentPos;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void ConcurrentArenaClear( ConcurrentArena* pArena )
+{
+    pArena->uiPos.store( pArena->uiBasePos, std::memory_order_relaxed );
+}
+
+} // namespace Core
+} // namespace Bogus
@@ -0,0 +1,168 @@
+#include "Core_DoubleEndedArena.h"
+#include "Core_Assert.h"
+#include "Core_Memory.h"
+#include "Core_Utility.h"
+#include "Globals.h"
+#include <bit>
+#include <new>
+
+namespace Bogus
+{
+namespace Core
+{
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+DoubleEndedArena* DoubleEndedArenaAlloc( ArenaAllocParams const& params )
+{
+    uint64 const uiPageSize = Memory::GetPageSize();
+    uint64 const uiMinReserveSize = MAX( params.uiReserveSize, 2 * uiPageSize );
+    uint64 const uiReserveSize = ALIGNUP_POW2( uiMinReserveSize, uiPageSize );
+    uint64 const uiMinCommitSize = MAX( params.uiCommitSize, DOUBLE_ENDED_ARENA_HEADER_SIZE );
+    // NOTE(asr): Both sides align their commit boundaries to this, so keep it a power of two
+    uint64 const uiCommitSize = std::bit_ceil( ALIGNUP_POW2( uiMinCommitSize, uiPageSize ) );
+
+    uint8* pMem = (uint8*)Memory::Reserve( uiReserveSize, params.uiFlags, params.iNumaNode );
+    if( pMem == 0 )
+    {
+        BGASSERT( 0, "Failed to Reserve pMemory" );
+        return nullptr;
+    }
+    Memory::Commit( pMem, uiCommitSize, params.uiFlags );
+
+    DoubleEndedArena* pArena = new( pMem ) DoubleEndedArena();
+    pArena->initParams = params;
+    pArena->initParams.uiCommitSize = uiCommitSize;
+    pArena->uiBottomPos = DOUBLE_ENDED_ARENA_HEADER_SIZE;
+    pArena->uiTopPos = uiReserveSize;
+    pArena->uiBottomCommitPos = uiCommitSize;
+    pArena->uiTopCommitPos = uiReserveSize;
+    pArena->uiReservedSize = uiReserveSize;
+    pArena->uiCommitCount = 1;
+    return pArena;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void DoubleEndedArenaRelease( DoubleEndedArena* pArena )
+{
+    Memory::Release( pArena, pArena->uiReservedSize, pArena->initParams.uiFlags );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint64 DoubleEndedArenaGetBottomPos( DoubleEndedArena* pArena )
+{
+    return pArena->uiBottomPos;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint64 DoubleEndedArenaGetTopPos( DoubleEndedArena* pArena )
+{
+    return pArena->uiTopPos;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint64 DoubleEndedArenaGetFreeSize( DoubleEndedArena* pArena )
+{
+    return pArena->uiTopPos - pArena->uiBottomPos;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint8* DoubleEndedArenaPushBottom( DoubleEndedArena* pArena, uint64 uiSize, uint64 uiAlignment )
+{
+    uint64 const uiPos = ALIGNUP_POW2( pArena->uiBottomPos, uiAlignment );
+    uint64 const uiNewPos = uiPos + uiSize;
+    if( uiNewPos > pArena->uiTopPos )
+    {
+        BGASSERT( 0, "Double ended arena ran out of memory." );
+        return nullptr;
+    }
+
+    if( uiNewPos > pArena->uiBottomCommitPos )
+    {
+        // NOTE(asr): Never commit into the pages the top side already committed
+        uint64 const uiCommitSize = pArena->initParams.uiCommitSize;
+        uint64 const uiAlignedPos = ALIGNUP_POW2( uiNewPos, uiCommitSize );
+        uint64 const uiCommitPos = MIN( uiAlignedPos, pArena->uiTopCommitPos );
+        uint8* pCommit = (uint8*)pArena + pArena->uiBottomCommitPos;
+        Memory::Commit( pCommit, uiCommitPos - pArena->uiBottomCommitPos,
+                        pArena->initParams.uiFlags );
+        pArena->uiBottomCommitPos = uiCommitPos;
+        ++pArena->uiCommitCount;
+    }
+
+    pArena->uiBottomPos = uiNewPos;
+    return (uint8*)pArena + uiPos;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint8* DoubleEndedArenaPushTop( DoubleEndedArena* pArena, uint64 uiSize, uint64 uiAlignment )
+{
+    if( uiSize > pArena->uiTopPos - pArena->uiBottomPos )
+    {
+        BGASSERT( 0, "Double ended arena ran out of memory." );
+        return nullptr;
+    }
+
+    uint64 const uiNewPos = ( pArena->uiTopPos - uiSize ) & ~( uiAlignment - 1 );
+    if( uiNewPos < pArena->uiBottomPos )
+    {
+        BGASSERT( 0, "Double ended arena ran out of memory." );
+        return nullptr;
+    }
+
+    if( uiNewPos < pArena->uiTopCommitPos )
+    {
+        uint64 const uiCommitSize = pArena->initParams.uiCommitSize;
+        uint64 const uiAlignedPos = uiNewPos & ~( uiCommitSize - 1 );
+        uint64 const uiCommitPos = MAX( uiAlignedPos, pArena->uiBottomCommitPos );
+        Memory::Commit( (uint8*)pArena + uiCommitPos, pArena->uiTopCommitPos - uiCommitPos,
+                        pArena->initParams.uiFlags );
+        pArena->uiTopCommitPos = uiCommitPos;
+        ++pArena->uiCommitCount;
+    }
+
+    pArena->uiTopPos = uiNewPos;
+    return (uint8*)pArena + uiNewPos;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void DoubleEndedArenaPopBottomTo( DoubleEndedArena* pArena, uint64 uiPos )
+{
+    uiPos = MAX( uiPos, DOUBLE_ENDED_ARENA_HEADER_SIZE );
+    BGASSERT( uiPos <= pArena->uiBottomPos, "Popping the bottom past its position." );
+    pArena->uiBottomPos = MIN( uiPos, pArena->uiBottomPos );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void DoubleEndedArenaPopTopTo( DoubleEndedArena* pArena, uint64 uiPos )
+{
+    uiPos = MIN( uiPos, pArena->uiReservedSize );
+    BGASSERT( uiPos >= pArena->uiTopPos, "Popping the top past its position." );
+    pArena->uiTopPos = MAX( uiPos, pArena->uiTopPos );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void DoubleEndedArenaClearTop( DoubleEndedArena* pArena )
+{
+    pArena->uiTopPos = pArena->uiReservedSize;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void DoubleEndedArenaClear( DoubleEndedArena* pArena )
+{
+    pArena->uiBottomPos = DOUBLE_ENDED_ARENA_HEADER_SIZE;
+    pArena->uiTopPos = pArena->uiReservedSize;
+}
+
+} // namespace Core
+} // namespace Bogus
@@ -0,0 +1,68 @@
+#include "Core_FrameArena.h"
+#include "Core_Assert.h"
+#include "Globals.h"
+
+namespace Bogus
+{
+namespace Core
+{
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void FrameArenaRingInit( FrameArenaRing* pRing, uint32 uiFrameCount,
+                         ArenaAllocParams const& params )
+{
+    BGASSERT( uiFrameCount > 0 && uiFrameCount <= FRAME_ARENA_MAX_FRAMES,
+              "Frame count out of range. Increase FRAME_ARENA_MAX_FRAMES." );
+    uiFrameCount = MIN( uiFrameCount, FRAME_ARENA_MAX_FRAMES );
+
+    *pRing = FrameArenaRing();
+    pRing->uiFrameCount = uiFrameCount;
+    for( uint32 i = 0; i < uiFrameCount; ++i )
+    {
+        pRing->pArenas[i] = ArenaAlloc( params );
+    }
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void FrameArenaRingRelease( FrameArenaRing* pRing )
+{
+    for( uint32 i = 0; i < pRing->uiFrameCount; ++i )
+    {
+        ArenaRelease( pRing->pArenas[i] );
+    }
+    *pRing = FrameArenaRing();
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+Arena* FrameArenaRingBeginFrame( FrameArenaRing* pRing, uint32 uiFrameIndex,
+                                 uint64 uiCompletedFenceValue )
+{
+    BGASSERT( uiFrameIndex < pRing->uiFrameCount, "Bad frame index." );
+    BGASSERT( pRing->uiFenceValues[uiFrameIndex] <= uiCompletedFenceValue,
+              "Frame arena reset while the GPU may still read it." );
+
+    pRing->uiCurrentFrame = uiFrameIndex;
+    Arena* pArena = pRing->pArenas[uiFrameIndex];
+    ArenaClear( pArena );
+    return pArena;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void FrameArenaRingEndFrame( FrameArenaRing* pRing, uint64 uiFenceValue )
+{
+    pRing->uiFenceValues[pRing->uiCurrentFrame] = uiFenceValue;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+Arena* FrameArenaRingGetCurrent( FrameArenaRing* pRing )
+{
+    return pRing->pArenas[pRing->uiCurrentFrame];
+}
+
+} // namespace Core
+} // namespace Bogus
@@ -0,0 +1,154 @@
+#include "Core_PersistentArena.h"
+#include "Core_Assert.h"
+#include "Core_Memory.h"
+#include "Core_Utility.h"
+#include "Globals.h"
+#include "MurmurHash3.h"
+#include <cstddef>
+#include <new>
+
+namespace Bogus
+{
+namespace Core
+{
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+static bool PersistentArenaValidate( PersistentArena* pArena, uint32 uiVersion,
+                                     uint64 uiFileSize )
+{
+    if( uiFileSize < PERSISTENT_ARENA_HEADER_SIZE )
+    {
+        return false;
+    }
+
+    bool const bHeaderValid = pArena->uiMagic == PERSISTENT_ARENA_MAGIC &&
+                              pArena->uiVersion == uiVersion &&
+                              pArena->uiHeaderSize == PERSISTENT_ARENA_HEADER_SIZE &&
+                              pArena->uiPos >= PERSISTENT_ARENA_HEADER_SIZE &&
+                              pArena->uiPos <= uiFileSize && pArena->uiRootPos < pArena->uiPos;
+    return bHeaderValid && pArena->uiChecksum == PersistentArenaCalcChecksum( pArena );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+PersistentArena* PersistentArenaOpen( PersistentArenaParams const& params, bool* pOutLoaded )
+{
+    uint64 const uiPageSize = Memory::GetPageSize();
+    uint64 const uiMinCapacity = MAX( params.uiCapacity, PERSISTENT_ARENA_HEADER_SIZE );
+    uint64 uiCapacity = ALIGNUP_POW2( uiMinCapacity, uiPageSize );
+
+    uint64 uiFileSize = 0;
+    uint8* pMem = (uint8*)Memory::MapFile( params.szPath, uiCapacity, &uiFileSize );
+    if( pMem && uiFileSize > uiCapacity )
+    {
+        // NOTE(asr): Map the whole file so data saved with a bigger capacity stays reachable
+        Memory::UnmapFile( pMem, uiCapacity );
+        uiCapacity = ALIGNUP_POW2( uiFileSize, uiPageSize );
+        pMem = (uint8*)Memory::MapFile( params.szPath, uiCapacity );
+    }
+    if( pMem == 0 )
+    {
+        BGASSERT( 0, "Failed to map persistent arena file" );
+        return nullptr;
+    }
+
+    PersistentArena* pArena = (PersistentArena*)pMem;
+    bool const bLoaded = PersistentArenaValidate( pArena, params.uiVersion, uiFileSize );
+    if( !bLoaded )
+    {
+        new( pArena ) PersistentArena();
+        pArena->uiVersion = params.uiVersion;
+        pArena->uiHeaderSize = PERSISTENT_ARENA_HEADER_SIZE;
+        pArena->uiPos = PERSISTENT_ARENA_HEADER_SIZE;
+    }
+    pArena->uiCapacity = uiCapacity;
+
+    if( pOutLoaded )
+    {
+        *pOutLoaded = bLoaded;
+    }
+    return pArena;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void PersistentArenaClose( PersistentArena* pArena )
+{
+    Memory::UnmapFile( pArena, pArena->uiCapacity );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void PersistentArenaSave( PersistentArena* pArena )
+{
+    pArena->uiChecksum = PersistentArenaCalcChecksum( pArena );
+    Memory::FlushFile( pArena, pArena->uiPos );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint32 PersistentArenaCalcChecksum( PersistentArena* pArena )
+{
+    // NOTE(asr): Hash the header fields between the checksum and the capacity, which depends on
+    // the mapping, then chain the data in chunks because MurmurHash3 takes an int length
+    uint64 const uiHeaderBegin = offsetof( PersistentArena, uiHeaderSize );
+    uint64 const uiHeaderEnd = offsetof( PersistentArena, uiCapacity );
+    uint32 uiHash = 0;
+    MurmurHash3_x86_32( &pArena->uiHeaderSize, (int)( uiHeaderEnd - uiHeaderBegin ),
+                        pArena->uiVersion, &uiHash );
+
+    uint8 const* pData = (uint8 const*)pArena + PERSISTENT_ARENA_HEADER_SIZE;
+    uint64 uiRemaining = pArena->uiPos - PERSISTENT_ARENA_HEADER_SIZE;
+    while( uiRemaining )
+    {
+        uint64 const uiChunk = MIN( uiRemaining, GIGABYTES( 1 ) );
+        MurmurHash3_x86_32( pData, (int)uiChunk, uiHash, &uiHash );
+        pData += uiChunk;
+        uiRemaining -= uiChunk;
+    }
+    return uiHash;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+uint8* PersistentArenaPush( PersistentArena* pArena, uint64 uiSize, uint64 uiAlignment )
+{
+    uint64 const uiPos = ALIGNUP_POW2( pArena->uiPos, uiAlignment );
+    uint64 const uiNewPos = uiPos + uiSize;
+    if( uiNewPos > pArena->uiCapacity )
+    {
+        BGASSERT( 0, "Persistent arena ran out of capacity." );
+        return nullptr;
+    }
+
+    pArena->uiPos = uiNewPos;
+    return (uint8*)pArena + uiPos;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void PersistentArenaClear( PersistentArena* pArena )
+{
+    pArena->uiPos = PERSISTENT_ARENA_HEADER_SIZE;
+    pArena->uiRootPos = 0;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void PersistentArenaSetRoot( PersistentArena* pArena, void* pRoot )
+{
+    uint64 const uiRootPos = pRoot ? (uint8*)pRoot - (uint8*)pArena : 0;
+    BGASSERT( uiRootPos < pArena->uiPos, "Root must be pushed from the persistent arena." );
+    pArena->uiRootPos = uiRootPos;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void* PersistentArenaGetRoot( PersistentArena* pArena )
+{
+    return pArena->uiRootPos ? (uint8*)pArena + pArena->uiRootPos : nullptr;
+}
+
+} // namespace Core
+} // namespace Bogus
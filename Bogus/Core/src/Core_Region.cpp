@@ -0,0 +1,221 @@
+#include "Core_Region.h"
+#include "Core_Arena.h"
+#include "Core_Assert.h"
+#include "Core_Memory.h"
+#include "Core_Utility.h"
+#include "Globals.h"
+#include <bit>
+#include <mutex>
+
+namespace Bogus
+{
+namespace Core
+{
+// NOTE(asr): Hundreds of thousands of regions would each split the range into separate mappings
+static constexpr uint32 REGION_MEM_FLAGS = Memory::eMemFlag_CommitOnTouch;
+
+struct RegionFreeNode
+{
+    uint8* pBase;
+    RegionFreeNode* pNext;
+};
+
+struct RegionShared
+{
+    std::mutex mutex;
+    uint8* pRanges[REGION_MAX_SHARED_RANGES] = {};
+    uint32 uiRangeCount = 0;
+    uint8* pCursor = nullptr;
+    uint8* pEnd = nullptr;
+    RegionFreeNode* pFreeLists[64] = {};
+    RegionFreeNode* pSpareNodes = nullptr;
+    Arena* pNodeArena = nullptr;
+    RegionStats stats;
+};
+static RegionShared s_Regions;
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+static uint8* RegionCarve( uint64 uiCap )
+{
+    if( s_Regions.pCursor && uiCap <= (uint64)( s_Regions.pEnd - s_Regions.pCursor ) )
+    {
+        uint8* pBase = s_Regions.pCursor;
+        s_Regions.pCursor += uiCap;
+        s_Regions.stats.uiCarvedSize += uiCap;
+        return pBase;
+    }
+
+    // NOTE(asr): The tail of the previous range is abandoned, it is never committed so only
+    // costs address space
+    if( s_Regions.uiRangeCount == REGION_MAX_SHARED_RANGES )
+    {
+        BGASSERT( 0, "Out of shared region ranges. Increase REGION_MAX_SHARED_RANGES." );
+        return nullptr;
+    }
+
+    uint8* pRange = (uint8*)Memory::Reserve( REGION_SHARED_RANGE_SIZE, REGION_MEM_FLAGS );
+    if( !pRange )
+    {
+        BGASSERT( 0, "Failed to Reserve pMemory" );
+        return nullptr;
+    }
+    s_Regions.pRanges[s_Regions.uiRangeCount++] = pRange;
+    s_Regions.pCursor = pRange + uiCap;
+    s_Regions.pEnd = pRange + REGION_SHARED_RANGE_SIZE;
+    s_Regions.stats.uiReservedSize += REGION_SHARED_RANGE_SIZE;
+    s_Regions.stats.uiCarvedSize += uiCap;
+    return pRange;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+bool RegionAlloc( Region* pRegion, uint64 uiCap )
+{
+    uiCap = std::bit_ceil( MAX( uiCap, REGION_MIN_CAP ) );
+    if( uiCap > REGION_SHARED_RANGE_SIZE )
+    {
+        BGASSERT( 0, "Region cap is bigger than a shared range." );
+        return false;
+    }
+
+    uint32 const uiClass = std::countr_zero( uiCap );
+    uint8* pBase = nullptr;
+    {
+        std::lock_guard<std::mutex> lock( s_Regions.mutex );
+        RegionFreeNode* pNode = s_Regions.pFreeLists[uiClass];
+        if( pNode )
+        {
+            pBase = pNode->pBase;
+            s_Regions.pFreeLists[uiClass] = pNode->pNext;
+            pNode->pNext = s_Regions.pSpareNodes;
+            s_Regions.pSpareNodes = pNode;
+            --s_Regions.stats.uiFreeRegionCount;
+        }
+        else
+        {
+            pBase = RegionCarve( uiCap );
+        }
+
+        if( pBase )
+        {
+            ++s_Regions.stats.uiRegionCount;
+        }
+    }
+
+    *pRegion = { pBase, 0, uiCap };
+    return pBase != nullptr;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void RegionRelease( Region* pRegion )
+{
+    if( !pRegion->pBase )
+    {
+        return;
+    }
+
+    if( pRegion->uiCommittedSize )
+    {
+        Memory::Decommit( pRegion->pBase, pRegion->uiCommittedSize, REGION_MEM_FLAGS );
+    }
+
+    uint32 const uiClass = std::countr_zero( pRegion->uiCap );
+    {
+        std::lock_guard<std::mutex> lock( s_Regions.mutex );
+        RegionFreeNode* pNode = s_Regions.pSpareNodes;
+        if( pNode )
+        {
+            s_Regions.pSpareNodes = pNode->pNext;
+        }
+        else
+        {
+            if( !s_Regions.pNodeArena )
+            {
+                s_Regions.pNodeArena =
+                    NEW_ARENA(.name = "RegionFreeNodes", .uiArenaFlags = eArenaFlag_Chained );
+            }
+            pNode = ArenaPushArrayNoZero<RegionFreeNode>( s_Regions.pNodeArena, 1 );
+        }
+
+        pNode->pBase = pRegion->pBase;
+        pNode->pNext = s_Regions.pFreeLists[uiClass];
+        s_Regions.pFreeLists[uiClass] = pNode;
+        s_Regions.stats.uiCommittedSize -= pRegion->uiCommittedSize;
+        --s_Regions.stats.uiRegionCount;
+        ++s_Regions.stats.uiFreeRegionCount;
+    }
+
+    *pRegion = Region();
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+bool RegionGrow( Region* pRegion, uint64 uiSize )
+{
+    if( uiSize <= pRegion->uiCommittedSize )
+    {
+        return true;
+    }
+
+    if( uiSize > pRegion->uiCap )
+    {
+        BGASSERT( 0, "Region grown past its cap." );
+        return false;
+    }
+
+    uint64 const uiNewCommittedSize = AlignSize( uiSize, Memory::GetPageSize() );
+    uint64 const uiGrowSize = uiNewCommittedSize - pRegion->uiCommittedSize;
+    Memory::Commit( pRegion->pBase + pRegion->uiCommittedSize, uiGrowSize, REGION_MEM_FLAGS );
+    pRegion->uiCommittedSize = uiNewCommittedSize;
+
+    std::lock_guard<std::mutex> lock( s_Regions.mutex );
+    s_Regions.stats.uiCommittedSize += uiGrowSize;
+    return true;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+bool RegionGrowGeometric( Region* pRegion, uint64 uiSize, uint64 uiMinStepSize )
+{
+    if( uiSize <= pRegion->uiCommittedSize )
+    {
+        return true;
+    }
+
+    uint64 const uiStepSize = MAX( pRegion->uiCommittedSize, uiMinStepSize );
+    uint64 const uiGrowSize = MAX( uiSize, pRegion->uiCommittedSize + uiStepSize );
+    uint64 const uiMaxSize = MAX( uiSize, pRegion->uiCap );
+    uint64 const uiCommitSize = MIN( uiGrowSize, uiMaxSize );
+    return RegionGrow( pRegion, uiCommitSize );
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+void RegionShrink( Region* pRegion, uint64 uiSize )
+{
+    uint64 const uiNewCommittedSize = AlignSize( uiSize, Memory::GetPageSize() );
+    if( uiNewCommittedSize >= pRegion->uiCommittedSize )
+    {
+        return;
+    }
+
+    uint64 const uiShrinkSize = pRegion->uiCommittedSize - uiNewCommittedSize;
+    Memory::Decommit( pRegion->pBase + uiNewCommittedSize, uiShrinkSize, REGION_MEM_FLAGS );
+    pRegion->uiCommittedSize = uiNewCommittedSize;
+
+    std::lock_guard<std::mutex> lock( s_Regions.mutex );
+    s_Regions.stats.uiCommittedSize -= uiShrinkSize;
+}
+
+// ------------------------------------------------------
+// ------------------------------------------------------
+RegionStats RegionGetStats()
+{
+    std::lock_guard<std::mutex> lock( s_Regions.mutex );
+    return s_Regions.stats;
+}
+
+} // namespace Core
+} // namespace Bogus
@@ -0,0 +1,245 @@
+#include "Core_Slab.h"
+#include "Core_Arena.h"
+#include "Core_Assert.h"
+#include "Globals.h"
+#include <mutex>
+
+namespace Bogus
+{
+namespace Core
+{
+static constexpr uint32 s_uiClassSizes[SLAB_CLASS_COUNT] = {
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096,
+};
+
+struct SlabFreeNode
+{
+    SlabFreeNode* pNext;
+};
+
+struct SlabClass
+{
+    std::mutex mutex;
+    SlabFreeNode* pFree = nullptr;
+    uint8* pBump = nullptr;
+    uint8* pBumpEnd = nullptr;
+    uint64 uiCarvedBytes = 0;
+};
+
+struct SlabHeap
+{
+    SlabHeap();
+
+    std::mutex arenaMutex;
+    Arena* pArena = nullptr;
+    SlabClass classes[SLAB_CLASS_COUNT];
+    uint8 sizeToClass[SLAB_MAX_ALLOC_SIZE / SLAB_MIN_ALIGNMENT + 1];
+};
+
+struct SlabThreadCache
+{
+    ~SlabThreadCache() { SlabFlushThreadCache(); }
+
+    SlabFreeNode* pFree[SLAB_CLASS_COUNT] = {};
+    uint32 uiCount[SLAB_CLASS_COUNT] = {};
+};
+
+thread_local static SlabThreadCache s_ThreadCache;
+
+// INTERNALS (DECLS) -------------------------------------------------------------------------------
+static SlabHeap& GetHeap();
+static uint32 GetClass( SlabHeap& heap, uint64 uiSize );
+static void Refill( SlabHeap& heap, uint32 uiClass );
+static void Drain( SlabHeap& heap, uint32 uiClass, uint32 uiCount );
+// INTERNALS (DECLS) -------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+SlabHeap::SlabHeap()
+{
+    pArena = ArenaAlloc( { .uiReserveSize = MEGABYTES( 256 ),
+                           .uiCommitSize = SLAB_SIZE,
+                           .name = "SlabArena",
+                           .uiArenaFlags = eArenaFlag_Chained } );
+
+    uint32 uiClass = 0;
+    for( uint32 i = 0; i <= SLAB_MAX_ALLOC_SIZE / SLAB_MIN_ALIGNMENT; ++i )
+    {
+        while( s_uiClassSizes[uiClass] < i * SLAB_MIN_ALIGNMENT )
+        {
+            ++uiClass;
+        }
+        sizeToClass[i] = (uint8)uiClass;
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+void* SlabAlloc( uint64 uiSize )
+{
+    SlabHeap& heap = GetHeap();
+    uint32 const uiClass = GetClass( heap, uiSize );
+    if( uiClass == SLAB_CLASS_COUNT )
+    {
+        BGASSERT( 0, "SlabAlloc size is bigger than SLAB_MAX_ALLOC_SIZE" );
+        return nullptr;
+    }
+
+    SlabThreadCache& cache = s_ThreadCache;
+    if( !cache.pFree[uiClass] )
+    {
+        Refill( heap, uiClass );
+        if( !cache.pFree[uiClass] )
+        {
+            return nullptr;
+        }
+    }
+
+    SlabFreeNode* pNode = cache.pFree[uiClass];
+    cache.pFree[uiClass] = pNode->pNext;
+    --cache.uiCount[uiClass];
+    return pNode;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+void SlabFree( void* pMem, uint64 uiSize )
+{
+    if( !pMem )
+    {
+        return;
+    }
+
+    SlabHeap& heap = GetHeap();
+    uint32 const uiClass = GetClass( heap, uiSize );
+    if( uiClass == SLAB_CLASS_COUNT )
+    {
+        BGASSERT( 0, "SlabFree size is bigger than SLAB_MAX_ALLOC_SIZE" );
+        return;
+    }
+
+    SlabThreadCache& cache = s_ThreadCache;
+    SlabFreeNode* pNode = (SlabFreeNode*)pMem;
+    pNode->pNext = cache.pFree[uiClass];
+    cache.pFree[uiClass] = pNode;
+
+    // NOTE(asr): Keep one batch around for the next allocs, hand the rest back
+    if( ++cache.uiCount[uiClass] >= SLAB_CACHE_BATCH * 2 )
+    {
+        Drain( heap, uiClass, SLAB_CACHE_BATCH );
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+void SlabFlushThreadCache()
+{
+    SlabHeap& heap = GetHeap();
+    for( uint32 uiClass = 0; uiClass < SLAB_CLASS_COUNT; ++uiClass )
+    {
+        Drain( heap, uiClass, s_ThreadCache.uiCount[uiClass] );
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+void SlabGetClassUsage( uint64 ( &uiOutBytes )[SLAB_CLASS_COUNT] )
+{
+    SlabHeap& heap = GetHeap();
+    for( uint32 uiClass = 0; uiClass < SLAB_CLASS_COUNT; ++uiClass )
+    {
+        SlabClass& slabClass = heap.classes[uiClass];
+        std::lock_guard<std::mutex> lock( slabClass.mutex );
+        uiOutBytes[uiClass] = slabClass.uiCarvedBytes;
+    }
+}
+
+// INTERNALS (IMPLS) -------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+static SlabHeap& GetHeap()
+{
+    // NOTE(asr): Never destroyed so thread caches can still flush during static destruction
+    static SlabHeap* s_pHeap = new SlabHeap();
+    return *s_pHeap;
+}
+
+// -------------------------------------------------------------------------------------------------
+static uint32 GetClass( SlabHeap& heap, uint64 uiSize )
+{
+    if( uiSize > SLAB_MAX_ALLOC_SIZE )
+    {
+        return SLAB_CLASS_COUNT;
+    }
+    return heap.sizeToClass[( uiSize + SLAB_MIN_ALIGNMENT - 1 ) / SLAB_MIN_ALIGNMENT];
+}
+
+// -------------------------------------------------------------------------------------------------
+static void Refill( SlabHeap& heap, uint32 uiClass )
+{
+    SlabThreadCache& cache = s_ThreadCache;
+    SlabClass& slabClass = heap.classes[uiClass];
+    uint64 const uiElemSize = s_uiClassSizes[uiClass];
+
+    std::lock_guard<std::mutex> lock( slabClass.mutex );
+    for( uint32 i = 0; i < SLAB_CACHE_BATCH; ++i )
+    {
+        SlabFreeNode* pNode = slabClass.pFree;
+        if( pNode )
+        {
+            slabClass.pFree = pNode->pNext;
+        }
+        else
+        {
+            if( (uint64)( slabClass.pBumpEnd - slabClass.pBump ) < uiElemSize )
+            {
+                uint8* pSlab = nullptr;
+                {
+                    std::lock_guard<std::mutex> arenaLock( heap.arenaMutex );
+                    pSlab = ArenaPush( heap.pArena, SLAB_SIZE, SLAB_MIN_ALIGNMENT );
+                }
+                if( !pSlab )
+                {
+                    break;
+                }
+                slabClass.pBump = pSlab;
+                slabClass.pBumpEnd = pSlab + SLAB_SIZE;
+                slabClass.uiCarvedBytes += SLAB_SIZE;
+            }
+            pNode = (SlabFreeNode*)slabClass.pBump;
+            slabClass.pBump += uiElemSize;
+        }
+
+        pNode->pNext = cache.pFree[uiClass];
+        cache.pFree[uiClass] = pNode;
+        ++cache.uiCount[uiClass];
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+static void Drain( SlabHeap& heap, uint32 uiClass, uint32 uiCount )
+{
+    SlabThreadCache& cache = s_ThreadCache;
+    if( !uiCount )
+    {
+        return;
+    }
+
+    // NOTE(asr): Unlink the first uiCount nodes outside the lock, then splice them in one go
+    SlabFreeNode* pFirst = cache.pFree[uiClass];
+    SlabFreeNode* pLast = pFirst;
+    for( uint32 i = 1; i < uiCount; ++i )
+    {
+        pLast = pLast->pNext;
+    }
+    cache.pFree[uiClass] = pLast->pNext;
+    cache.uiCount[uiClass] -= uiCount;
+
+    SlabClass& slabClass = heap.classes[uiClass];
+    std::lock_guard<std::mutex> lock( slabClass.mutex );
+    pLast->pNext = slabClass.pFree;
+    slabClass.pFree = pFirst;
+}
+// INTERNALS (IMPLS) -------------------------------------------------------------------------------
+
+} // namespace Core
+} // namespace Bogus
@@ -0,0 +1,368 @@
+#include "Core_Tlsf.h"
+#include "Core_Assert.h"
+#include "Core_Memory.h"
+#include "Core_Utility.h"
+#include "Globals.h"
+#include <bit>
+#include <new>
+
+namespace Bogus
+{
+namespace Core
+{
+static constexpr uint64 TLSF_BLOCK_FREE = 1;
+static constexpr uint64 TLSF_SMALL_BLOCK_SIZE = 1ull << TLSF_FL_SHIFT;
+
+// INTERNALS (DECLS) -------------------------------------------------------------------------------
+static uint64 BlockSize( TlsfBlock const* pBlock );
+static bool BlockIsFree( TlsfBlock const* pBlock );
+static TlsfBlock* BlockNext( TlsfBlock* pBlock );
+static TlsfBlock* BlockPrev( TlsfBlock* pBlock );
+static void BlockSetSize( TlsfBlock* pBlock, uint64 uiSize, bool bFree );
+static void MappingInsert( uint64 uiSize, uint32* pOutFl, uint32* pOutSl );
+static void MappingSearch( uint64 uiSize, uint32* pOutFl, uint32* pOutSl );
+static TlsfBlock* FindSuitable( TlsfHeap* pHeap, uint32 uiFl, uint32 uiSl );
+static void InsertFree( TlsfHeap* pHeap, TlsfBlock* pBlock );
+static void RemoveFree( TlsfHeap* pHeap, TlsfBlock* pBlock );
+static TlsfBlock* MergeFree( TlsfHeap* pHeap, TlsfBlock* pBlock );
+static bool Grow( TlsfHeap* pHeap, uint64 uiBlockSize );
+// INTERNALS (DECLS) -------------------------------------------------------------------------------
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+TlsfHeap* TlsfCreate( TlsfAllocParams const& params )
+{
+    uint64 const uiPageSize = Memory::GetPageSize();
+    uint64 const uiFirstBlockPos = ALIGNUP_POW2( TLSF_HEADER_SIZE, TLSF_ALIGNMENT );
+    uint64 const uiMinCommit = uiFirstBlockPos + TLSF_MIN_BLOCK_SIZE + TLSF_BLOCK_HEADER_SIZE;
+    uint64 const uiReserveSize = ALIGNUP_POW2( params.uiReserveSize, uiPageSize );
+    uint64 const uiMinCommitSize = MAX( params.uiCommitSize, uiMinCommit );
+    uint64 const uiCommitSize = ALIGNUP_POW2( uiMinCommitSize, uiPageSize );
+
+    uint8* pMem = (uint8*)Memory::Reserve( uiReserveSize, params.uiFlags, params.iNumaNode );
+    if( pMem == 0 )
+    {
+        BGASSERT( 0, "Failed to Reserve pMemory" );
+        return nullptr;
+    }
+    Memory::Commit( pMem, uiCommitSize, params.uiFlags );
+
+    TlsfHeap* pHeap = new( pMem ) TlsfHeap();
+    pHeap->initParams = params;
+    pHeap->uiReservedSize = uiReserveSize;
+    pHeap->uiCommittedSize = uiCommitSize;
+    pHeap->uiCommitCount = 1;
+
+    // NOTE(asr): One free block spanning the committed memory, closed by a zero sized used block
+    TlsfBlock* pFirst = (TlsfBlock*)( pMem + uiFirstBlockPos );
+    TlsfBlock* pSentinel = (TlsfBlock*)( pMem + uiCommitSize - TLSF_BLOCK_HEADER_SIZE );
+    uint64 const uiFirstSize = (uint8*)pSentinel - (uint8*)pFirst;
+    pFirst->uiPrevSize = 0;
+    BlockSetSize( pFirst, uiFirstSize, true );
+    pSentinel->uiPrevSize = uiFirstSize;
+    BlockSetSize( pSentinel, 0, false );
+    pHeap->pSentinel = pSentinel;
+    InsertFree( pHeap, pFirst );
+
+    return pHeap;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+void TlsfDestroy( TlsfHeap* pHeap )
+{
+    Memory::Release( pHeap, pHeap->uiReservedSize, pHeap->initParams.uiFlags );
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+void* TlsfAlloc( TlsfHeap* pHeap, uint64 uiSize )
+{
+    uint64 uiBlockSize = ALIGNUP_POW2( uiSize + TLSF_BLOCK_HEADER_SIZE, TLSF_ALIGNMENT );
+    uiBlockSize = MAX( uiBlockSize, TLSF_MIN_BLOCK_SIZE );
+
+    uint32 uiFl = 0;
+    uint32 uiSl = 0;
+    MappingSearch( uiBlockSize, &uiFl, &uiSl );
+    if( uiFl >= TLSF_FL_COUNT )
+    {
+        BGASSERT( 0, "TlsfAlloc size is too big" );
+        return nullptr;
+    }
+
+    TlsfBlock* pBlock = FindSuitable( pHeap, uiFl, uiSl );
+    if( !pBlock && Grow( pHeap, uiBlockSize ) )
+    {
+        pBlock = FindSuitable( pHeap, uiFl, uiSl );
+    }
+
+    if( !pBlock )
+    {
+        BGASSERT( 0, "Failed to allocate memory" );
+        return nullptr;
+    }
+    RemoveFree( pHeap, pBlock );
+
+    // NOTE(asr): Split off the tail if it can hold a block of its own
+    uint64 const uiFoundSize = BlockSize( pBlock );
+    if( uiFoundSize - uiBlockSize >= TLSF_MIN_BLOCK_SIZE )
+    {
+        TlsfBlock* pRemainder = (TlsfBlock*)( (uint8*)pBlock + uiBlockSize );
+        uint64 const uiRemainderSize = uiFoundSize - uiBlockSize;
+        pRemainder->uiPrevSize = uiBlockSize;
+        BlockSetSize( pRemainder, uiRemainderSize, true );
+        BlockNext( pRemainder )->uiPrevSize = uiRemainderSize;
+        InsertFree( pHeap, pRemainder );
+    }
+    else
+    {
+        uiBlockSize = uiFoundSize;
+    }
+
+    BlockSetSize( pBlock, uiBlockSize, false );
+    pHeap->uiUsedSize += uiBlockSize;
+    return (uint8*)pBlock + TLSF_BLOCK_HEADER_SIZE;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+void TlsfFree( TlsfHeap* pHeap, void* pMem )
+{
+    if( !pMem )
+    {
+        return;
+    }
+
+    TlsfBlock* pBlock = (TlsfBlock*)( (uint8*)pMem - TLSF_BLOCK_HEADER_SIZE );
+    if( BlockIsFree( pBlock ) )
+    {
+        BGASSERT( 0, "Double free passed to TlsfFree" );
+        return;
+    }
+
+    pHeap->uiUsedSize -= BlockSize( pBlock );
+    BlockSetSize( pBlock, BlockSize( pBlock ), true );
+    InsertFree( pHeap, MergeFree( pHeap, pBlock ) );
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+uint64 TlsfGetAllocSize( void* pMem )
+{
+    TlsfBlock* pBlock = (TlsfBlock*)( (uint8*)pMem - TLSF_BLOCK_HEADER_SIZE );
+    return BlockSize( pBlock ) - TLSF_BLOCK_HEADER_SIZE;
+}
+
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+TlsfStats TlsfGetStats( TlsfHeap* pHeap )
+{
+    TlsfStats stats;
+    stats.uiUsedSize = pHeap->uiUsedSize;
+    stats.uiFreeSize = pHeap->uiFreeSize;
+    stats.uiCommittedSize = pHeap->uiCommittedSize;
+
+    // NOTE(asr): Only the highest non-empty bucket can hold the largest block
+    if( pHeap->uiFlBitmap )
+    {
+        uint32 const uiFl = 31 - std::countl_zero( pHeap->uiFlBitmap );
+        uint32 const uiSl = 31 - std::countl_zero( pHeap->uiSlBitmaps[uiFl] );
+        for( TlsfBlock* pBlock = pHeap->pFreeLists[uiFl][uiSl]; pBlock;
+             pBlock = pBlock->pNextFree )
+        {
+            stats.uiLargestFreeBlock = MAX( stats.uiLargestFreeBlock, BlockSize( pBlock ) );
+        }
+    }
+
+    if( stats.uiFreeSize )
+    {
+        stats.fFragmentation = 1.0f - (float)stats.uiLargestFreeBlock / (float)stats.uiFreeSize;
+    }
+    return stats;
+}
+
+// INTERNALS (IMPLS) -------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+static uint64 BlockSize( TlsfBlock const* pBlock )
+{
+    return pBlock->uiSize & ~TLSF_BLOCK_FREE;
+}
+
+// -------------------------------------------------------------------------------------------------
+static bool BlockIsFree( TlsfBlock const* pBlock )
+{
+    return pBlock->uiSize & TLSF_BLOCK_FREE;
+}
+
+// -------------------------------------------------------------------------------------------------
+static TlsfBlock* BlockNext( TlsfBlock* pBlock )
+{
+    return (TlsfBlock*)( (uint8*)pBlock + BlockSize( pBlock ) );
+}
+
+// -------------------------------------------------------------------------------------------------
+static TlsfBlock* BlockPrev( TlsfBlock* pBlock )
+{
+    return pBlock->uiPrevSize ? (TlsfBlock*)( (uint8*)pBlock - pBlock->uiPrevSize ) : nullptr;
+}
+
+// -------------------------------------------------------------------------------------------------
+static void BlockSetSize( TlsfBlock* pBlock, uint64 uiSize, bool bFree )
+{
+    pBlock->uiSize = uiSize | ( bFree ? TLSF_BLOCK_FREE : 0 );
+}
+
+// -------------------------------------------------------------------------------------------------
+static void MappingInsert( uint64 uiSize, uint32* pOutFl, uint32* pOutSl )
+{
+    if( uiSize < TLSF_SMALL_BLOCK_SIZE )
+    {
+        *pOutFl = 0;
+        *pOutSl = (uint32)( uiSize / ( TLSF_SMALL_BLOCK_SIZE / TLSF_SL_COUNT ) );
+        return;
+    }
+
+    uint32 const uiMsb = 63 - std::countl_zero( uiSize );
+    *pOutSl = (uint32)( uiSize >> ( uiMsb - TLSF_SL_COUNT_LOG2 ) ) ^ TLSF_SL_COUNT;
+    *pOutFl = uiMsb - ( TLSF_FL_SHIFT - 1 );
+}
+
+// -------------------------------------------------------------------------------------------------
+static void MappingSearch( uint64 uiSize, uint32* pOutFl, uint32* pOutSl )
+{
+    // NOTE(asr): Round up to the next second level so any block in the found list is big enough
+    if( uiSize >= TLSF_SMALL_BLOCK_SIZE )
+    {
+        uint32 const uiMsb = 63 - std::countl_zero( uiSize );
+        uiSize += ( 1ull << ( uiMsb - TLSF_SL_COUNT_LOG2 ) ) - 1;
+    }
+    MappingInsert( uiSize, pOutFl, pOutSl );
+}
+
+// -------------------------------------------------------------------------------------------------
+static TlsfBlock* FindSuitable( TlsfHeap* pHeap, uint32 uiFl, uint32 uiSl )
+{
+    uint32 uiSlMap = pHeap->uiSlBitmaps[uiFl] & ( ~0u << uiSl );
+    if( !uiSlMap )
+    {
+        uint32 const uiFlMap = uiFl + 1 < 32 ? pHeap->uiFlBitmap & ( ~0u << ( uiFl + 1 ) ) : 0;
+        if( !uiFlMap )
+        {
+            return nullptr;
+        }
+        uiFl = std::countr_zero( uiFlMap );
+        uiSlMap = pHeap->uiSlBitmaps[uiFl];
+    }
+    uiSl = std::countr_zero( uiSlMap );
+    return pHeap->pFreeLists[uiFl][uiSl];
+}
+
+// -------------------------------------------------------------------------------------------------
+static void InsertFree( TlsfHeap* pHeap, TlsfBlock* pBlock )
+{
+    uint32 uiFl = 0;
+    uint32 uiSl = 0;
+    MappingInsert( BlockSize( pBlock ), &uiFl, &uiSl );
+
+    TlsfBlock*& pHead = pHeap->pFreeLists[uiFl][uiSl];
+    pBlock->pPrevFree = nullptr;
+    pBlock->pNextFree = pHead;
+    if( pHead )
+    {
+        pHead->pPrevFree = pBlock;
+    }
+    pHead = pBlock;
+
+    pHeap->uiFlBitmap |= 1u << uiFl;
+    pHeap->uiSlBitmaps[uiFl] |= 1u << uiSl;
+    pHeap->uiFreeSize += BlockSize( pBlock );
+}
+
+// -------------------------------------------------------------------------------------------------
+static void RemoveFree( TlsfHeap* pHeap, TlsfBlock* pBlock )
+{
+    uint32 uiFl = 0;
+    uint32 uiSl = 0;
+    MappingInsert( BlockSize( pBlock ), &uiFl, &uiSl );
+
+    if( pBlock->pPrevFree )
+    {
+        pBlock->pPrevFree->pNextFree = pBlock->pNextFree;
+    }
+    else
+    {
+        pHeap->pFreeLists[uiFl][uiSl] = pBlock->pNextFree;
+        if( !pBlock->pNextFree )
+        {
+            pHeap->uiSlBitmaps[uiFl] &= ~( 1u << uiSl );
+            if( !pHeap->uiSlBitmaps[uiFl] )
+            {
+                pHeap->uiFlBitmap &= ~( 1u << uiFl );
+            }
+        }
+    }
+
+    if( pBlock->pNextFree )
+    {
+        pBlock->pNextFree->pPrevFree = pBlock->pPrevFree;
+    }
+    pHeap->uiFreeSize -= BlockSize( pBlock );
+}
+
+// -------------------------------------------------------------------------------------------------
+// Coalesces a free block that is not in any list with its free physical neighbours
+static TlsfBlock* MergeFree( TlsfHeap* pHeap, TlsfBlock* pBlock )
+{
+    TlsfBlock* pNext = BlockNext( pBlock );
+    if( BlockIsFree( pNext ) )
+    {
+        RemoveFree( pHeap, pNext );
+        BlockSetSize( pBlock, BlockSize( pBlock ) + BlockSize( pNext ), true );
+    }
+
+    TlsfBlock* pPrev = BlockPrev( pBlock );
+    if( pPrev && BlockIsFree( pPrev ) )
+    {
+        RemoveFree( pHeap, pPrev );
+        BlockSetSize( pPrev, BlockSize( pPrev ) + BlockSize( pBlock ), true );
+        pBlock = pPrev;
+    }
+
+    BlockNext( pBlock )->uiPrevSize = BlockSize( pBlock );
+    return pBlock;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Commits more pages and turns the old sentinel into a free block covering them
+static bool Grow( TlsfHeap* pHeap, uint64 uiBlockSize )
+{
+    // NOTE(asr): Worst case the new block does not merge with a free tail, and we must reach the
+    // rounded up search size for the block to be found in the searched list
+    uint64 const uiNeeded = uiBlockSize * 2 + TLSF_BLOCK_HEADER_SIZE;
+    uint64 const uiNewCommitAligned =
+        AlignSize( pHeap->uiCommittedSize + uiNeeded, pHeap->initParams.uiCommitSize );
+    uint64 const uiNewCommitClamped = MIN( uiNewCommitAligned, pHeap->uiReservedSize );
+    if( uiNewCommitClamped <= pHeap->uiCommittedSize )
+    {
+        return false;
+    }
+
+    uint8* pBase = (uint8*)pHeap;
+    Memory::Commit( pBase + pHeap->uiCommittedSize, uiNewCommitClamped - pHeap->uiCommittedSize,
+                    pHeap->initParams.uiFlags );
+    ++pHeap->uiCommitCount;
+
+    TlsfBlock* pBlock = pHeap->pSentinel;
+    TlsfBlock* pSentinel = (TlsfBlock*)( pBase + uiNewCommitClamped - TLSF_BLOCK_HEADER_SIZE );
+    BlockSetSize( pBlock, (uint8*)pSentinel - (uint8*)pBlock, true );
+    BlockSetSize( pSentinel, 0, false );
+    pHeap->pSentinel = pSentinel;
+    pHeap->uiCommittedSize = uiNewCommitClamped;
+
+    InsertFree( pHeap, MergeFree( pHeap, pBlock ) );
+    return true;
+}
+// INTERNALS (IMPLS) -------------------------------------------------------------------------------
+
+} // namespace Core
+} // namespace Bogus
@@ -0,0 +1,267 @@
+#include "Core_Memory.h"
+#include "Core_Utility.h"
+#include "Globals.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+namespace Bogus::Core::Memory
+{
+static constexpr uint64 LARGE_PAGE_SIZE = MEGABYTES( 2 );
+static constexpr int MPOL_PREFERRED_MODE = 1;
+static constexpr int MPOL_INTERLEAVE_MODE = 3;
+
+static void* ReserveRange( uint64 uiMappedSize, uint32 uiFlags );
+static void ApplyNumaPolicy( void* pMem, uint64 uiSize, int32 iNumaNode );
+
+uint64 GetPageSize()
+{
+    static uint64 const s_uiPageSize = (uint64)sysconf( _SC_PAGESIZE );
+    return s_uiPageSize;
+}
+
+uint64 GetLargePageSize()
+{
+    return LARGE_PAGE_SIZE;
+}
+
+uint32 GetNumaNodeCount()
+{
+    static uint32 const s_uiNodeCount = []()
+    {
+        // NOTE(asr): Format is a range list such as "0" or "0-3", the last number is the highest
+        uint32 uiHighest = 0;
+        FILE* pFile = fopen( "/sys/devices/system/node/online", "r" );
+        if( pFile )
+        {
+            uint32 uiNode = 0;
+            while( fscanf( pFile, "%u", &uiNode ) == 1 )
+            {
+                uiHighest = MAX( uiHighest, uiNode );
+                if( fgetc( pFile ) == EOF )
+                {
+                    break;
+                }
+            }
+            fclose( pFile );
+        }
+        return MIN( uiHighest + 1, NUMA_MAX_NODES );
+    }();
+    return s_uiNodeCount;
+}
+
+uint32 GetCurrentNumaNode()
+{
+#ifdef __linux__
+    unsigned int uiCpu = 0;
+    unsigned int uiNode = 0;
+    if( syscall( SYS_getcpu, &uiCpu, &uiNode, nullptr ) == 0 )
+    {
+        return uiNode;
+    }
+#endif
+    return 0;
+}
+
+uint64 GetReservedSize( uint64 uiSize, uint32 uiFlags )
+{
+    // NOTE(asr): Huge pages are reserved from the pool at mmap time, so take only what is asked
+    // for. The THP fallback keeps the same size so Release does not need to know which one ran.
+    if( uiFlags & eMemFlag_HugeTLB )
+    {
+        return ALIGNUP_POW2( uiSize, LARGE_PAGE_SIZE );
+    }
+    return AlignSize( uiSize, RESERVE_GRANULARITY );
+}
+
+void* Reserve( uint64 uiSize, uint32 uiFlags, int32 iNumaNode )
+{
+    uint64 const uiMappedSize = GetReservedSize( uiSize, uiFlags );
+    void* pMem = ReserveRange( uiMappedSize, uiFlags );
+    if( pMem && iNumaNode != NUMA_NODE_ANY )
+    {
+        ApplyNumaPolicy( pMem, uiMappedSize, iNumaNode );
+    }
+    return pMem;
+}
+
+static void* ReserveRange( uint64 uiMappedSize, uint32 uiFlags )
+{
+    int const iMapFlags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+    int const iProt = uiFlags & eMemFlag_CommitOnTouch ? PROT_READ | PROT_WRITE : PROT_NONE;
+
+    if( uiFlags & eMemFlag_HugeTLB )
+    {
+        // NOTE(asr): Without MAP_NORESERVE the kernel reserves the huge pages up front, so a
+        // missing or short hugetlbfs pool fails here instead of raising SIGBUS on first touch
+        int const iHugeMapFlags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+        void* pMem = mmap( 0, uiMappedSize, iProt, iHugeMapFlags, -1, 0 );
+        if( pMem != MAP_FAILED )
+        {
+            return pMem;
+        }
+        // NOTE(asr): No hugetlbfs pool big enough, fall back to transparent huge pages
+        uiFlags |= eMemFlag_LargePages;
+    }
+
+    if( !( uiFlags & eMemFlag_LargePages ) )
+    {
+        void* pMem = mmap( 0, uiMappedSize, iProt, iMapFlags, -1, 0 );
+        return pMem == MAP_FAILED ? nullptr : pMem;
+    }
+
+    // NOTE(asr): Over-reserve so the base can be snapped to a large page boundary, then trim
+    uint64 const uiPaddedSize = uiMappedSize + LARGE_PAGE_SIZE;
+    void* pRaw = mmap( 0, uiPaddedSize, iProt, iMapFlags, -1, 0 );
+    if( pRaw == MAP_FAILED )
+    {
+        return nullptr;
+    }
+
+    uint64 const uiRaw = (uint64)pRaw;
+    uint64 const uiAligned = ALIGNUP_POW2( uiRaw, LARGE_PAGE_SIZE );
+    uint64 const uiHeadSize = uiAligned - uiRaw;
+    uint64 const uiTailSize = uiPaddedSize - uiHeadSize - uiMappedSize;
+    if( uiHeadSize )
+    {
+        munmap( pRaw, uiHeadSize );
+    }
+    if( uiTailSize )
+    {
+        munmap( (uint8*)uiAligned + uiMappedSize, uiTailSize );
+    }
+
+    madvise( (void*)uiAligned, uiMappedSize, MADV_HUGEPAGE );
+    return (void*)uiAligned;
+}
+
+static void ApplyNumaPolicy( void* pMem, uint64 uiSize, int32 iNumaNode )
+{
+#ifdef __linux__
+    uint32 const uiNodeCount = GetNumaNodeCount();
+    if( uiNodeCount < 2 )
+    {
+        return;
+    }
+
+    // NOTE(asr): Policies set on the reservation apply when pages are first faulted in
+    uint64 uiNodeMask = 0;
+    int iMode = MPOL_PREFERRED_MODE;
+    if( iNumaNode == NUMA_NODE_INTERLEAVE )
+    {
+        uiNodeMask = uiNodeCount == 64 ? max_uint64 : ( 1ull << uiNodeCount ) - 1;
+        iMode = MPOL_INTERLEAVE_MODE;
+    }
+    else if( iNumaNode >= 0 && (uint32)iNumaNode < uiNodeCount )
+    {
+        uiNodeMask = 1ull << iNumaNode;
+    }
+    else
+    {
+        return;
+    }
+    syscall( SYS_mbind, pMem, uiSize, iMode, &uiNodeMask, NUMA_MAX_NODES + 1, 0 );
+#endif
+}
+
+void Release( void* pMem, uint64 uiSize, uint32 uiFlags )
+{
+    munmap( pMem, GetReservedSize( uiSize, uiFlags ) );
+}
+
+void Commit( void* pMem, uint64 uiSize, uint32 uiFlags )
+{
+    // NOTE(asr): Match VirtualAlloc and commit every page touched by the range
+    uint64 const uiPageSize = GetPageSize();
+    uint64 const uiBegin = (uint64)pMem & ~( uiPageSize - 1 );
+    uint64 const uiEnd = ALIGNUP_POW2( (uint64)pMem + uiSize, uiPageSize );
+    void* pPage = (void*)uiBegin;
+    if( !( uiFlags & eMemFlag_CommitOnTouch ) )
+    {
+        mprotect( pPage, uiEnd - uiBegin, PROT_READ | PROT_WRITE );
+    }
+
+    if( uiFlags & eMemFlag_Prefault )
+    {
+        // NOTE(asr): MADV_POPULATE_WRITE needs Linux 5.14+, touch each page on older kernels
+        if( madvise( pPage, uiEnd - uiBegin, MADV_POPULATE_WRITE ) != 0 )
+        {
+            volatile uint8* pTouch = (uint8*)pPage;
+            for( uint64 uiOffset = 0; uiOffset < uiEnd - uiBegin; uiOffset += uiPageSize )
+            {
+                pTouch[uiOffset] = pTouch[uiOffset];
+            }
+        }
+    }
+}
+
+void Decommit( void* pMem, uint64 uiSize, uint32 uiFlags )
+{
+    // NOTE(asr): Only drop pages fully inside the range so neighbouring data survives
+    uint64 const uiPageSize = GetPageSize();
+    uint64 const uiBegin = ALIGNUP_POW2( (uint64)pMem, uiPageSize );
+    uint64 const uiEnd = ( (uint64)pMem + uiSize ) & ~( uiPageSize - 1 );
+    if( uiEnd <= uiBegin )
+    {
+        return;
+    }
+    madvise( (void*)uiBegin, uiEnd - uiBegin, MADV_DONTNEED );
+    if( !( uiFlags & eMemFlag_CommitOnTouch ) )
+    {
+        mprotect( (void*)uiBegin, uiEnd - uiBegin, PROT_NONE );
+    }
+}
+
+void* MapFile( char const* szPath, uint64 uiSize, uint64* pOutFileSize )
+{
+    int const iFile = open( szPath, O_RDWR | O_CREAT, 0644 );
+    if( iFile < 0 )
+    {
+        return nullptr;
+    }
+
+    struct stat fileStat;
+    uint64 const uiFileSize = fstat( iFile, &fileStat ) == 0 ? (uint64)fileStat.st_size : 0;
+    if( pOutFileSize )
+    {
+        *pOutFileSize = uiFileSize;
+    }
+
+    // NOTE(asr): Growing with ftruncate leaves a sparse file, untouched pages cost no disk
+    if( uiFileSize < uiSize && ftruncate( iFile, (off_t)uiSize ) != 0 )
+    {
+        close( iFile );
+        return nullptr;
+    }
+
+    void* pMem = mmap( nullptr, uiSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFile, 0 );
+    close( iFile );
+    return pMem == MAP_FAILED ? nullptr : pMem;
+}
+
+void UnmapFile( void* pMem, uint64 uiSize )
+{
+    munmap( pMem, uiSize );
+}
+
+void FlushFile( void* pMem, uint64 uiSize )
+{
+    msync( pMem, uiSize, MS_SYNC );
+}
+
+void Abort()
+{
+    _exit( 1 );
+}
+
+} // namespace Bogus::Core::Memory
@@ -13,29 +13,114 @@ uint64 GetPageSize()
     return info.dwPageSize;
 }
 
-void* Reserve( uint64 uiSize )
+uint64 GetLargePageSize()
 {
-    uint64 const uiGBSnappedSize = AlignSize( uiSize, GIGABYTES( 1 ) );
+    uint64 const uiLargePageSize = GetLargePageMinimum();
+    return uiLargePageSize ? uiLargePageSize : GetPageSize();
+}
+
+uint32 GetNumaNodeCount()
+{
+    ULONG uiHighestNode = 0;
+    GetNumaHighestNodeNumber( &uiHighestNode );
+    return MIN( (uint32)uiHighestNode + 1, NUMA_MAX_NODES );
+}
+
+uint32 GetCurrentNumaNode()
+{
+    PROCESSOR_NUMBER processor;
+    GetCurrentProcessorNumberEx( &processor );
+    USHORT uiNode = 0;
+    GetNumaProcessorNodeEx( &processor, &uiNode );
+    return uiNode;
+}
+
+uint64 GetReservedSize( uint64 uiSize, uint32 uiFlags )
+{
+    return AlignSize( uiSize, RESERVE_GRANULARITY );
+}
+
+void* Reserve( uint64 uiSize, uint32 uiFlags, int32 iNumaNode )
+{
+    // NOTE(asr): MEM_LARGE_PAGES must be committed at reserve time and needs SeLockMemoryPrivilege,
+    // which does not fit the reserve/commit model. Large page flags are ignored here.
+    uint64 const uiGBSnappedSize = GetReservedSize( uiSize, uiFlags );
+    if( iNumaNode >= 0 )
+    {
+        // NOTE(asr): There is no interleave policy for VirtualAlloc, only a preferred node
+        return VirtualAllocExNuma( GetCurrentProcess(), 0, uiGBSnappedSize, MEM_RESERVE,
+                                   PAGE_NOACCESS, (DWORD)iNumaNode );
+    }
     void* pMem = VirtualAlloc( 0, uiGBSnappedSize, MEM_RESERVE, PAGE_NOACCESS );
     return pMem;
 }
 
-void Release( void* pMem, uint64 uiSize )
+void Release( void* pMem, uint64 uiSize, uint32 uiFlags )
 {
     VirtualFree( pMem, 0, MEM_RELEASE );
 }
 
-void Commit( void* pMem, uint64 uiSize )
+void Commit( void* pMem, uint64 uiSize, uint32 uiFlags )
 {
-    uint64 const uiPageSnappedSize = AlignSize( uiSize, GetPageSize() );
+    uint64 const uiPageSize = GetPageSize();
+    uint64 const uiPageSnappedSize = AlignSize( uiSize, uiPageSize );
     VirtualAlloc( pMem, uiPageSnappedSize, MEM_COMMIT, PAGE_READWRITE );
+
+    if( uiFlags & eMemFlag_Prefault )
+    {
+        volatile uint8* pTouch = (uint8*)pMem;
+        for( uint64 uiOffset = 0; uiOffset < uiPageSnappedSize; uiOffset += uiPageSize )
+        {
+            pTouch[uiOffset] = pTouch[uiOffset];
+        }
+    }
 }
 
-void Decommit( void* pMem, uint64 uiSize )
+void Decommit( void* pMem, uint64 uiSize, uint32 uiFlags )
 {
     VirtualFree( pMem, uiSize, MEM_DECOMMIT );
 }
 
+void* MapFile( char const* szPath, uint64 uiSize, uint64* pOutFileSize )
+{
+    HANDLE hFile = CreateFileA( szPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if( hFile == INVALID_HANDLE_VALUE )
+    {
+        return nullptr;
+    }
+
+    LARGE_INTEGER fileSize = {};
+    GetFileSizeEx( hFile, &fileSize );
+    if( pOutFileSize )
+    {
+        *pOutFileSize = (uint64)fileSize.QuadPart;
+    }
+
+    // NOTE(asr): The mapping grows the file to its maximum size
+    HANDLE hMapping = CreateFileMappingA( hFile, nullptr, PAGE_READWRITE, (DWORD)( uiSize >> 32 ),
+                                          (DWORD)( uiSize & 0xffffffff ), nullptr );
+    CloseHandle( hFile );
+    if( !hMapping )
+    {
+        return nullptr;
+    }
+
+    void* pMem = MapViewOfFile( hMapping, FILE_MAP_ALL_ACCESS, 0, 0, uiSize );
+    CloseHandle( hMapping );
+    return pMem;
+}
+
+void UnmapFile( void* pMem, uint64 uiSize )
+{
+    UnmapViewOfFile( pMem );
+}
+
+void FlushFile( void* pMem, uint64 uiSize )
+{
+    FlushViewOfFile( pMem, uiSize );
+}
+
 void Abort()
 {
     ExitProcess( 1 );
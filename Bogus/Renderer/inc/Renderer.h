@@ -1,6 +1,7 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include "Core_Arena.h"
 #include "Globals.h"
 
 namespace Bogus::App
@@ -12,5 +13,12 @@ void Initialize();
 void Render();
 void Resize( uint32 uiWidth, uint32 uiHeight );
 void Terminate();
+
+// Transient memory for the frame being recorded, reclaimed once the GPU finished that frame
+Core::Arena* GetFrameArena();
+template <typename T> T* FrameAlloc( uint32 uiCount )
+{
+    return Core::ArenaPushArrayNoZero<T>( GetFrameArena(), uiCount );
+}
 } // namespace Bogus::Renderer
 #endif
@@ -31,6 +31,7 @@ class CommandQueue
     uint64 Signal();
 
     void WaitForFence( uint64 uiFenceValue );
+    uint64 GetCompletedFenceValue();
     void Flush();
 
     ID3D12Device2* m_pDevice;
@@ -5,6 +5,7 @@
 
 #include "App_Windows.h"
 #include "Core_Assert.h"
+#include "Core_FrameArena.h"
 
 #include "DirectXMath.h"
 #include "d3d12.h"
@@ -38,6 +39,7 @@ static CommandQueue g_ComputeQueue;
 static uint32 g_uiCurrentBackBufferIndex = 0;
 uint64 g_uiFenceValue = 0;
 uint64 g_uiFrameFenceValues[MAX_FRAMES] = {};
+static Core::FrameArenaRing g_FrameArenas;
 
 static ID3D12RootSignature* g_RootSignature;
 static ID3D12PipelineState* g_PSO;
@@ -153,6 +155,7 @@ void Initialize()
     CreateRootSignature( g_Device, &g_RootSignature );
     CreatePipelineState( g_Device, g_RootSignature, &g_PSO );
     CreateConstantBuffers( g_Device );
+    Core::FrameArenaRingInit( &g_FrameArenas, MAX_FRAMES, { .name = "FrameArena" } );
 
     // viewport / scissor
     g_Viewport = { 0.0f,
@@ -176,8 +179,11 @@ void Initialize()
 
 void Render()
 {
-    uint64 const uiBackBufferFence = g_uiFrameFenceValues[g_uiCurrentBackBufferIndex];
-    g_DirectQueue.WaitForFence( uiBackBufferFence );
+    g_DirectQueue.WaitForFence( g_uiFrameFenceValues[g_uiCurrentBackBufferIndex] );
+    // NOTE(asr): Resize evens out g_uiFrameFenceValues but the ring keeps the real per frame
+    // values, which can be higher, so hand it what the GPU actually reached
+    Core::FrameArenaRingBeginFrame( &g_FrameArenas, g_uiCurrentBackBufferIndex,
+                                    g_DirectQueue.GetCompletedFenceValue() );
 
     CommandList* pCmdList = NULL;
     g_DirectQueue.GetCommandList( &pCmdList );
@@ -246,6 +252,7 @@ void Render()
         uint64 uiSignalFenceValue = g_DirectQueue.ExecuteCommandList( pCmdList );
 
         g_uiFrameFenceValues[g_uiCurrentBackBufferIndex] = uiSignalFenceValue;
+        Core::FrameArenaRingEndFrame( &g_FrameArenas, uiSignalFenceValue );
 
         uint32 uiSyncInterval = g_uiRendererFlags & eRenderer_VSyncEnabled ? 1 : 0;
         uint32 uiPresentFlags =
@@ -326,11 +333,18 @@ void Terminate()
 
     DXRelease( &g_Device );
 
+    Core::FrameArenaRingRelease( &g_FrameArenas );
+
     g_uiCurrentBackBufferIndex = 0;
     g_uiRTVDescriptorSize = 0;
     g_uiFenceValue = 0;
 }
 
+Core::Arena* GetFrameArena()
+{
+    return Core::FrameArenaRingGetCurrent( &g_FrameArenas );
+}
+
 static void GetHardwareAdapter( IDXGIFactory4* pFactory, IDXGIAdapter1** ppOutAdapter )
 {
     *ppOutAdapter = nullptr;
@@ -151,6 +151,13 @@ void CommandQueue::WaitForFence( uint64 uiFenceValue )
     WaitForFenceValue( m_pFence, uiFenceValue, m_FenceEvent );
 }
 
+// -------------------------------------------------------------------------------------------------
+// -------------------------------------------------------------------------------------------------
+uint64 CommandQueue::GetCompletedFenceValue()
+{
+    return m_pFence->GetCompletedValue();
+}
+
 // -------------------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------------------
 void CommandQueue::Flush()